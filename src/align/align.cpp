@@ -19,6 +19,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
 #include <memory>
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include "../basic/value.h"
 #include "align.h"
 #include "../data/reference.h"
@@ -29,7 +32,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../util/merge_sort.h"
 #include "extend.h"
 #include "../util/algo/radix_sort.h"
+#include "../util/memory/arena.h"
 #include "target.h"
+#include "../util/system/system.h"
 
 using std::get;
 using std::tuple;
@@ -43,6 +48,7 @@ struct Align_fetcher
 	{
 		it_ = begin;
 		end_ = end;
+		qend_ = qend;
 		queue_ = unique_ptr<Queue>(new Queue(qbegin, qend));
 	}
 	bool operator()(size_t query)
@@ -65,17 +71,52 @@ struct Align_fetcher
 		if (target_parallel)
 			queue_->release();
 	}
+	static size_t query_end()
+	{
+		return qend_;
+	}
 	size_t query;
 	hit* begin, *end;
 	bool target_parallel;
 private:	
 	static hit* it_, *end_;
+	static size_t qend_;
 	static unique_ptr<Queue> queue_;
 };
 
 unique_ptr<Queue> Align_fetcher::queue_;
 hit* Align_fetcher::it_;
 hit* Align_fetcher::end_;
+size_t Align_fetcher::qend_;
+
+// Output of duplicate queries that are aligned in a later query range than
+// their representative.
+static std::map<size_t, TextBuffer*> deferred_output;
+static std::mutex deferred_output_mtx;
+
+static void push_duplicate_output(size_t query, TextBuffer *buf)
+{
+	if (query < Align_fetcher::query_end()) {
+		OutputSink::get().push(query, buf);
+		return;
+	}
+	std::lock_guard<std::mutex> lock(deferred_output_mtx);
+	deferred_output[query] = buf;
+}
+
+static void push_deferred_output(size_t query)
+{
+	TextBuffer *buf;
+	{
+		std::lock_guard<std::mutex> lock(deferred_output_mtx);
+		auto it = deferred_output.find(query);
+		if (it == deferred_output.end())
+			return;
+		buf = it->second;
+		deferred_output.erase(it);
+	}
+	OutputSink::get().push(query, buf);
+}
 
 TextBuffer* legacy_pipeline(Align_fetcher &hits, const Metadata *metadata, const Parameters *params, Statistics &stat) {
 	if (hits.end == hits.begin) {
@@ -116,13 +157,21 @@ void align_worker(size_t thread_id, const Parameters *params, const Metadata *me
 	Align_fetcher hits;
 	Statistics stat;
 	DpStat dp_stat;
+	Util::Memory::Arena hsp_arena;
+	const Util::Memory::Arena::Scope arena_scope(hsp_arena);
 	while (hits.get()) {
+		hsp_arena.reset();
 		if(config.frame_shift != 0) {
 			TextBuffer *buf = legacy_pipeline(hits, metadata, params, stat);
 			OutputSink::get().push(hits.query, buf);
 			hits.release();
 			continue;
 		}
+		if (query_dedup && query_dedup->member(hits.query)) {
+			push_deferred_output(hits.query);
+			hits.release();
+			continue;
+		}
 		task_timer timer;
 		vector<Extension::Match> matches = Extension::extend(*params, hits.query, hits.begin, hits.end, *metadata, stat, hits.target_parallel || config.swipe_all ? DP::PARALLEL : 0);
 		TextBuffer *buf = blocked_processing ? Extension::generate_intermediate_output(matches, hits.query) : Extension::generate_output(matches, hits.query, stat, *metadata, *params);
@@ -131,6 +180,15 @@ void align_worker(size_t thread_id, const Parameters *params, const Metadata *me
 			query_aligned[hits.query] = true;
 		}
 		OutputSink::get().push(hits.query, buf);
+		if (query_dedup)
+			for (uint32_t m = query_dedup->next(hits.query); m != QueryDedup::NONE; m = query_dedup->next(m)) {
+				buf = blocked_processing ? Extension::generate_intermediate_output(matches, m) : Extension::generate_output(matches, m, stat, *metadata, *params);
+				if (!matches.empty() && (!config.unaligned.empty() || !config.aligned_file.empty())) {
+					std::lock_guard<std::mutex> lock(query_aligned_mtx);
+					query_aligned[m] = true;
+				}
+				push_duplicate_output(m, buf);
+			}
 		if (hits.target_parallel)
 			stat.inc(Statistics::TIME_TARGET_PARALLEL, timer.microseconds());
 		hits.release();
@@ -139,6 +197,66 @@ void align_worker(size_t thread_id, const Parameters *params, const Metadata *me
 	::dp_stat += dp_stat;
 }
 
+// Adjusted target matrices only depend on the masked target sequence. They are
+// retained per reference block so that later query chunks aligned against the
+// same block can reuse them instead of repeating the matrix adjustment. Block
+// numbers are not stable across query chunks (lowmem chunking, the renumbered
+// blocks of a symmetric self-search), so blocks are identified by the database
+// ids of their first and last sequence.
+typedef std::pair<unsigned, unsigned> BlockKey;
+
+static std::map<BlockKey, vector<int16_t*>> retained_target_matrices;
+static size_t retained_target_matrix_count = 0;
+
+static void delete_matrices(vector<int16_t*> &v)
+{
+	for (int16_t* i : v)
+		delete[] i;
+	v.clear();
+}
+
+static BlockKey block_key(size_t n)
+{
+	return { block_to_database_id[0], block_to_database_id[n - 1] };
+}
+
+static void init_target_matrices()
+{
+	const size_t n = ref_seqs::get().get_length();
+	if (n > 0) {
+		auto it = retained_target_matrices.find(block_key(n));
+		if (it != retained_target_matrices.end() && it->second.size() == n) {
+			Extension::target_matrices.swap(it->second);
+			retained_target_matrices.erase(it);
+			retained_target_matrix_count -= n - std::count(Extension::target_matrices.begin(), Extension::target_matrices.end(), nullptr);
+			return;
+		}
+	}
+	Extension::target_matrices.insert(Extension::target_matrices.end(), n, nullptr);
+}
+
+static void retain_target_matrices()
+{
+	const size_t n = Extension::target_matrices.size() - std::count(Extension::target_matrices.begin(), Extension::target_matrices.end(), nullptr);
+	const double limit = total_ram() / 16;
+	if (!Extension::target_matrices.empty() && (retained_target_matrix_count + n) * TRUE_AA * TRUE_AA * sizeof(int16_t) / 1e9 <= limit) {
+		vector<int16_t*> &v = retained_target_matrices[block_key(Extension::target_matrices.size())];
+		retained_target_matrix_count -= v.size() - std::count(v.begin(), v.end(), nullptr);
+		delete_matrices(v);
+		v.swap(Extension::target_matrices);
+		retained_target_matrix_count += n;
+	}
+	delete_matrices(Extension::target_matrices);
+}
+
+void free_target_matrices()
+{
+	for (auto &i : retained_target_matrices)
+		delete_matrices(i.second);
+	retained_target_matrices.clear();
+	retained_target_matrix_count = 0;
+}
+
 void align_queries(Trace_pt_buffer &trace_pts, Consumer* output_file, const Parameters &params, const Metadata &metadata)
 {
 	size_t max_size = std::min(size_t(config.chunk_size*1e9 * 10 * 2) / config.lowmem / 3, config.trace_pt_fetch_size);
@@ -146,7 +264,7 @@ void align_queries(Trace_pt_buffer &trace_pts, Consumer* output_file, const Para
 		max_size = std::max(max_size, size_t(config.memory_limit * 1e9));
 	pair<size_t, size_t> query_range;
 	if (Stats::CBS::avg_matrix(config.comp_based_stats)) {
-		Extension::target_matrices.insert(Extension::target_matrices.end(), ref_seqs::get().get_length(), nullptr);
+		init_target_matrices();
 		Extension::target_matrix_count = 0;
 	}
 	
@@ -186,8 +304,8 @@ void align_queries(Trace_pt_buffer &trace_pts, Consumer* output_file, const Para
 		delete hit_buf;
 	}
 	statistics.max(Statistics::SEARCH_TEMP_SPACE, trace_pts.total_disk_size());
-	for (auto i : Extension::target_matrices)
-		delete[] i;
-	Extension::target_matrices.clear();
+	statistics.max(Statistics::SEARCH_TEMP_SPACE_RAW, trace_pts.total_raw_disk_size());
+	if (Stats::CBS::avg_matrix(config.comp_based_stats))
+		retain_target_matrices();
 	statistics.inc(Statistics::MATRIX_ADJUST_COUNT, Extension::target_matrix_count);
 }
\ No newline at end of file
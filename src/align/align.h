@@ -45,6 +45,7 @@ private:
 };
 
 void align_queries(Trace_pt_buffer &trace_pts, Consumer* output_file, const Parameters &params, const Metadata &metadata);
+void free_target_matrices();
 
 namespace ExtensionPipeline {
 	namespace Swipe {
@@ -28,21 +28,21 @@ using std::list;
 
 namespace Extension {
 
-static void max_hsp_culling(list<Hsp>& hsps) {
+static void max_hsp_culling(HspList& hsps) {
 	if (config.max_hsps > 0 && hsps.size() > config.max_hsps) {
-		list<Hsp>::iterator i = hsps.begin();
+		HspList::iterator i = hsps.begin();
 		for (unsigned n = 0; n < config.max_hsps; ++n)
 			++i;
 		hsps.erase(i, hsps.end());
 	}
 }
 
-static void inner_culling(list<Hsp>& hsps, int source_query_len) {
+static void inner_culling(HspList& hsps, int source_query_len) {
 	for (Hsp& h : hsps)
 		h.query_source_range = TranslatedPosition::absolute_interval(TranslatedPosition(h.query_range.begin_, Frame(h.frame)), TranslatedPosition(h.query_range.end_, Frame(h.frame)), source_query_len);
 	hsps.sort();
 	const double overlap = config.inner_culling_overlap / 100.0;
-	for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end();) {
+	for (HspList::iterator i = hsps.begin(); i != hsps.end();) {
 		if (i->is_enveloped_by(hsps.begin(), i, overlap))
 			i = hsps.erase(i);
 		else
@@ -53,7 +53,7 @@ static void inner_culling(list<Hsp>& hsps, int source_query_len) {
 }
 
 void Target::inner_culling(int source_query_len) {
-	list<Hsp> hsps;
+	HspList hsps;
 	for (unsigned frame = 0; frame < align_mode.query_contexts; ++frame)
 		hsps.splice(hsps.end(), hsp[frame]);
 	Extension::inner_culling(hsps, source_query_len);
@@ -128,7 +128,7 @@ void Target::apply_filters(int source_query_len, const char *query_title, const
 	filter_score = 0;
 	filter_evalue = DBL_MAX;
 	for (unsigned frame = 0; frame < align_mode.query_contexts; ++frame) {
-		for (list<Hsp>::iterator i = hsp[frame].begin(); i != hsp[frame].end();) {
+		for (HspList::iterator i = hsp[frame].begin(); i != hsp[frame].end();) {
 			if (filter_hsp(*i, source_query_len, query_title, len, title, query_seq, seq))
 				i = hsp[frame].erase(i);
 			else {
@@ -145,7 +145,7 @@ void Match::apply_filters(int source_query_len, const char *query_title, const s
 	const char *title = ref_ids::get()[target_block_id];
 	const sequence seq = ref_seqs::get()[target_block_id];
 	const int len = seq.length();
-	for (list<Hsp>::iterator i = hsp.begin(); i != hsp.end();) {
+	for (HspList::iterator i = hsp.begin(); i != hsp.end();) {
 		if (filter_hsp(*i, source_query_len, query_title, len, title, query_seq, seq))
 			i = hsp.erase(i);
 		else
@@ -38,7 +38,7 @@ struct Match {
 		filter_evalue(filter_evalue),
 		ungapped_score(ungapped_score)
 	{}
-	void add_hit(std::list<Hsp> &list, std::list<Hsp>::iterator it) {
+	void add_hit(HspList &list, HspList::iterator it) {
 		hsp.splice(hsp.end(), list, it);
 	}
 	static bool cmp_evalue(const Match& m, const Match& n) {
@@ -47,7 +47,7 @@ struct Match {
 	static bool cmp_score(const Match& m, const Match& n) {
 		return m.filter_score > n.filter_score || (m.filter_score == n.filter_score && m.target_block_id < n.target_block_id);
 	}
-	Match(size_t target_block_id, std::array<std::list<Hsp>, MAX_CONTEXT> &hsp, int ungapped_score);
+	Match(size_t target_block_id, std::array<HspList, MAX_CONTEXT> &hsp, int ungapped_score);
 	void inner_culling(int source_query_len);
 	void max_hsp_culling();
 	void apply_filters(int source_query_len, const char *query_title, const sequence& query_seq);
@@ -55,7 +55,7 @@ struct Match {
 	int filter_score;
 	double filter_evalue;
 	int ungapped_score;
-	std::list<Hsp> hsp;
+	HspList hsp;
 };
 
 std::vector<Match> extend(const Parameters &params, size_t query_id, hit* begin, hit* end, const Metadata &metadata, Statistics &stat, int flags);
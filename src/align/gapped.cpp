@@ -66,7 +66,7 @@ int band(int len) {
 	}
 }
 
-Match::Match(size_t target_block_id, std::array<std::list<Hsp>, MAX_CONTEXT> &hsps, int ungapped_score):
+Match::Match(size_t target_block_id, std::array<HspList, MAX_CONTEXT> &hsps, int ungapped_score):
 	target_block_id(target_block_id),
 	filter_score(0),
 	filter_evalue(DBL_MAX),
@@ -148,7 +148,7 @@ vector<Target> align(const vector<WorkTarget> &targets, const sequence *query_se
 	for (unsigned frame = 0; frame < align_mode.query_contexts; ++frame) {
 		if (dp_targets[frame].empty())
 			continue;
-		list<Hsp> hsp = DP::BandedSwipe::swipe(
+		HspList hsp = DP::BandedSwipe::swipe(
 			query_seq[frame],
 			dp_targets[frame][0],
 			dp_targets[frame][1],
@@ -179,7 +179,7 @@ vector<Target> full_db_align(const sequence *query_seq, const Bias_correction *q
 	vector<Target> r;
 	Stats::TargetMatrix matrix;
 
-	list<Hsp> hsp = DP::BandedSwipe::swipe(
+	HspList hsp = DP::BandedSwipe::swipe(
 		query_seq[0],
 		v,
 		v,
@@ -242,7 +242,7 @@ vector<Match> align(vector<Target> &targets, const sequence *query_seq, const Bi
 	for (unsigned frame = 0; frame < align_mode.query_contexts; ++frame) {
 		if (dp_targets[frame].empty())
 			continue;
-		list<Hsp> hsp = DP::BandedSwipe::swipe(
+		HspList hsp = DP::BandedSwipe::swipe(
 			query_seq[frame],
 			dp_targets[frame][0],
 			dp_targets[frame][1],
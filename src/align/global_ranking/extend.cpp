@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../dp/dp.h"
 #include "../data/queries.h"
 #include "../basic/masking.h"
+#include "../../util/memory/arena.h"
 
 using std::unique_ptr;
 using std::mutex;
@@ -80,7 +81,10 @@ void extend_query(const QueryList& query_list, const TargetMap& db2block_id, con
 void align_worker(InputFile* query_list, const TargetMap* db2block_id, const Parameters* params, const Metadata* metadata, uint32_t* next_query) {
 	QueryList input;
 	Statistics stats;
+	Util::Memory::Arena hsp_arena;
+	const Util::Memory::Arena::Scope arena_scope(hsp_arena);
 	while (input = fetch_query_targets(*query_list, *next_query), !input.targets.empty()) {
+		hsp_arena.reset();
 		for (uint32_t i = input.last_query_block_id; i < input.query_block_id; ++i)
 			OutputSink::get().push(i, nullptr);
 		extend_query(input, *db2block_id, *params, *metadata, stats);
@@ -93,7 +97,8 @@ void extend(DatabaseFile& db, TempFile& merged_query_list, BitVector& ranking_db
 	InputFile query_list(merged_query_list);
 	vector<uint32_t> block2db_id;
 	db.rewind();
- 	db.load_seqs(&block2db_id, SIZE_MAX, &ref_seqs::data_, &ref_ids::data_, true, &ranking_db_filter, true);
+ 	const bool mask_on_load = config.masking == 1 && db.soft_masked();
+	db.load_seqs(&block2db_id, SIZE_MAX, &ref_seqs::data_, &ref_ids::data_, true, &ranking_db_filter, true, Chunk(), true, mask_on_load);
 	ReferenceDictionary::get().set_block2db(&block2db_id);
 	TargetMap db2block_id;
 	db2block_id.reserve(block2db_id.size());
@@ -102,7 +107,7 @@ void extend(DatabaseFile& db, TempFile& merged_query_list, BitVector& ranking_db
 	timer.finish();
 	verbose_stream << "#Ranked database sequences: " << ref_seqs::get().get_length() << endl;
 
-	if (config.masking == 1) {
+	if (config.masking == 1 && !mask_on_load) {
 		timer.go("Masking reference");
 		size_t n = mask_seqs(*ref_seqs::data_, Masking::get());
 		timer.finish();
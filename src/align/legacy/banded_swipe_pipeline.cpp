@@ -91,7 +91,7 @@ struct Target : public ::Target
 	{
 		filter_score = 0;
 		filter_evalue = DBL_MAX;
-		for (list<Hsp>::const_iterator i = hsps.begin(); i != hsps.end(); ++i) {
+		for (HspList::const_iterator i = hsps.begin(); i != hsps.end(); ++i) {
 			filter_score = std::max(filter_score, (int)i->score);
 			filter_evalue = std::min(filter_evalue, i->evalue);
 		}
@@ -107,7 +107,7 @@ struct Target : public ::Target
 		inner_culling();
 		if (config.frame_shift)
 			return;
-		for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end(); ++i)
+		for (HspList::iterator i = hsps.begin(); i != hsps.end(); ++i)
 			i->query_source_range = TranslatedPosition::absolute_interval(TranslatedPosition(i->query_range.begin_, Frame(i->frame)), TranslatedPosition(i->query_range.end_, Frame(i->frame)), mapper.source_query_len);
 	}
 
@@ -153,12 +153,12 @@ void Pipeline::run_swipe(bool score_only)
 	vector<DpTarget> vf, vr;
 	for (size_t i = 0; i < n_targets(); ++i)
 		target(i).add(*this, vf, vr, (int)i);
-	list<Hsp> hsp;
+	HspList hsp;
 	hsp = banded_3frame_swipe(translated_query, FORWARD, vf.begin(), vf.end(), this->dp_stat, score_only, target_parallel);
 	hsp.splice(hsp.end(), banded_3frame_swipe(translated_query, REVERSE, vr.begin(), vr.end(), this->dp_stat, score_only, target_parallel));
 	
 	while (!hsp.empty()) {
-		list<Hsp> &l = target(hsp.begin()->swipe_target).hsps;
+		HspList &l = target(hsp.begin()->swipe_target).hsps;
 		l.splice(l.end(), hsp, hsp.begin());
 	}
 }
@@ -30,7 +30,7 @@ using namespace std;
 
 bool Target::envelopes(const Hsp_traits &t, double p) const
 {
-	for (list<Hsp_traits>::const_iterator i = ts.begin(); i != ts.end(); ++i)
+	for (HspTraitsList::const_iterator i = ts.begin(); i != ts.end(); ++i)
 		if (t.query_source_range.overlap_factor(i->query_source_range) >= p)
 			return true;
 	return false;
@@ -38,7 +38,7 @@ bool Target::envelopes(const Hsp_traits &t, double p) const
 
 bool Target::is_enveloped(const Target &t, double p) const
 {
-	for (list<Hsp_traits>::const_iterator i = ts.begin(); i != ts.end(); ++i)
+	for (HspTraitsList::const_iterator i = ts.begin(); i != ts.end(); ++i)
 		if (!t.envelopes(*i, p))
 			return false;
 	return true;
@@ -201,7 +201,7 @@ bool QueryMapper::generate_output(TextBuffer &buffer, Statistics &stat)
 {
 	std::stable_sort(targets.begin(), targets.end(), config.toppercent == 100.0 ? Target::compare_evalue : Target::compare_score);
 
-	unsigned n_hsp = 0, n_target_seq = 0, hit_hsps = 0;
+	unsigned n_hsp = 0, n_target_seq = 0, n_hit = 0, hit_hsps = 0;
 	unique_ptr<TargetCulling> target_culling(TargetCulling::get());
 	const unsigned query_len = (unsigned)query_seq(0).length();
 	size_t seek_pos = 0;
@@ -226,8 +226,9 @@ bool QueryMapper::generate_output(TextBuffer &buffer, Statistics &stat)
 
 		target_culling->add(targets[i]);
 		
+		vector<Hsp*> hsps;
 		hit_hsps = 0;
-		for (list<Hsp>::iterator j = targets[i].hsps.begin(); j != targets[i].hsps.end(); ++j) {
+		for (HspList::iterator j = targets[i].hsps.begin(); j != targets[i].hsps.end(); ++j) {
 			if (config.max_hsps > 0 && hit_hsps >= config.max_hsps)
 				break;
 
@@ -246,22 +247,29 @@ bool QueryMapper::generate_output(TextBuffer &buffer, Statistics &stat)
 				if (*f == Output_format::daa)
 					write_daa_record(buffer, *j, subject_id);
 				else
-					f->print_match(Hsp_context(*j,
+					hsps.push_back(&*j);
+			}
+
+			++n_hsp;
+			++hit_hsps;
+		}
+
+		if (!hsps.empty())
+			for (const string &title : Output_format::report_titles(ref_title)) {
+				for (size_t k = 0; k < hsps.size(); ++k)
+					f->print_match(Hsp_context(*hsps[k],
 						query_id,
 						translated_query,
 						query_title,
 						subject_id,
 						database_id,
-						ref_title,
+						title.c_str(),
 						subject_len,
-						n_target_seq,
-						hit_hsps,
+						n_hit,
+						(unsigned)k,
 						ref_seqs::get()[subject_id]), metadata, buffer);
+				++n_hit;
 			}
-
-			++n_hsp;
-			++hit_hsps;
-		}
 		++n_target_seq;
 	}
 
@@ -301,7 +309,7 @@ void Target::inner_culling()
 		filter_score = 0;
 		filter_evalue = DBL_MAX;
 	}
-	for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end();) {
+	for (HspList::iterator i = hsps.begin(); i != hsps.end();) {
 		if (i->is_enveloped_by(hsps.begin(), i, 0.5))
 			i = hsps.erase(i);
 		else
@@ -311,7 +319,7 @@ void Target::inner_culling()
 
 void Target::apply_filters(int dna_len, int subject_len, const char *query_title, const char *ref_title)
 {
-	for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end();) {
+	for (HspList::iterator i = hsps.begin(); i != hsps.end();) {
 		if (i->id_percent() < config.min_id
 			|| i->query_cover_percent(dna_len) < config.query_cover
 			|| i->subject_cover_percent(subject_len) < config.subject_cover)
@@ -58,10 +58,10 @@ struct Seed_hit
 	{
 		return ungapped.score > rhs.ungapped.score;
 	}
-	bool is_enveloped(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, int dna_len) const
+	bool is_enveloped(HspList::const_iterator begin, HspList::const_iterator end, int dna_len) const
 	{
 		const DiagonalSegment d(ungapped, ::Frame(frame_));
-		for (std::list<Hsp>::const_iterator i = begin; i != end; ++i)
+		for (HspList::const_iterator i = begin; i != end; ++i)
 			if (i->envelopes(d, dna_len))
 				return true;
 		return false;
@@ -132,7 +132,7 @@ struct Target
 	}
 	void fill_source_ranges(size_t query_len)
 	{
-		for (list<Hsp_traits>::iterator i = ts.begin(); i != ts.end(); ++i)
+		for (HspTraitsList::iterator i = ts.begin(); i != ts.end(); ++i)
 			i->query_source_range = TranslatedPosition::absolute_interval(TranslatedPosition(i->query_range.begin_, Frame(i->frame)), TranslatedPosition(i->query_range.end_, Frame(i->frame)), (int)query_len);
 	}
 	void add_ranges(vector<int32_t> &v);
@@ -149,8 +149,8 @@ struct Target
 	float filter_time;
 	bool outranked;
 	size_t begin, end;
-	list<Hsp> hsps;
-	list<Hsp_traits> ts;
+	HspList hsps;
+	HspTraitsList ts;
 	Seed_hit top_hit;
 	std::set<unsigned> taxon_rank_ids;
 
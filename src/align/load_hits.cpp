@@ -57,7 +57,7 @@ void load_hits(hit* begin, hit* end, FlatArray<SeedHit> &hits, vector<uint32_t>
 		}
 	}
 	else {
-		typename vector<size_t>::const_iterator limit_begin = ref_seqs::get().limits_begin(), it = limit_begin;
+		const size_t *limit_begin = ref_seqs::get().limits_begin(), *it = limit_begin;
 		for (const hit* i = begin; i < end; ++i) {
 			const size_t subject_offset = (uint64_t)i->subject_;
 			while (*it <= subject_offset) ++it;
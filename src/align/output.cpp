@@ -35,7 +35,7 @@ TextBuffer* generate_output(vector<Match> &targets, size_t query_block_id, Stati
 	TextBuffer* out = new TextBuffer;
 	std::unique_ptr<Output_format> f(output_format->clone());
 	size_t seek_pos = 0;
-	unsigned n_hsp = 0, hit_hsps = 0;
+	unsigned n_hsp = 0, n_hit = 0, hit_hsps;
 	TranslatedSequence query = query_seqs::get().translated_seq(align_mode.query_translated ? query_source_seqs::get()[query_block_id] : query_seqs::get()[query_block_id], query_block_id*align_mode.query_contexts);
 	const unsigned query_len = (unsigned)query.index(0).length();
 	const char *query_title = query_ids::get()[query_block_id];
@@ -53,27 +53,30 @@ TextBuffer* generate_output(vector<Match> &targets, size_t query_block_id, Stati
 		const unsigned subject_len = (unsigned)ref_seqs::get()[subject_id].length();
 		const char *ref_title = ref_ids::get()[subject_id];
 
-		hit_hsps = 0;
-		for (Hsp &hsp : targets[i].hsp) {
-			if (*f == Output_format::daa)
+		if (*f == Output_format::daa)
+			for (Hsp &hsp : targets[i].hsp)
 				write_daa_record(*out, hsp, subject_id);
-			else
-				f->print_match(Hsp_context(hsp,
-					query_block_id,
-					query,
-					query_title,
-					subject_id,
-					database_id,
-					ref_title,
-					subject_len,
-					i,
-					hit_hsps,
-					ref_seqs::get()[subject_id],
-					targets[i].ungapped_score), metadata, *out);
-			
-			++n_hsp;
-			++hit_hsps;
-		}
+		else
+			for (const string &title : Output_format::report_titles(ref_title)) {
+				hit_hsps = 0;
+				for (Hsp &hsp : targets[i].hsp) {
+					f->print_match(Hsp_context(hsp,
+						query_block_id,
+						query,
+						query_title,
+						subject_id,
+						database_id,
+						title.c_str(),
+						subject_len,
+						n_hit,
+						hit_hsps,
+						ref_seqs::get()[subject_id],
+						targets[i].ungapped_score), metadata, *out);
+					++hit_hsps;
+				}
+				++n_hit;
+			}
+		n_hsp += (unsigned)targets[i].hsp.size();
 	}
 
 	if (*f == Output_format::daa) {
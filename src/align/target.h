@@ -94,7 +94,7 @@ struct WorkTarget {
 	size_t block_id;
 	sequence seq;
 	int ungapped_score;
-	std::array<std::list<Hsp_traits>, MAX_CONTEXT> hsp;
+	std::array<HspTraitsList, MAX_CONTEXT> hsp;
 	Stats::TargetMatrix matrix;
 };
 
@@ -111,8 +111,8 @@ struct Target {
 		matrix(matrix)
 	{}
 
-	void add_hit(std::list<Hsp> &list, std::list<Hsp>::iterator it) {
-		std::list<Hsp> &l = hsp[it->frame];
+	void add_hit(HspList &list, HspList::iterator it) {
+		HspList &l = hsp[it->frame];
 		l.splice(l.end(), list, it);
 		filter_evalue = std::min(filter_evalue, l.back().evalue);
 		filter_score = std::max(filter_score, l.back().score);
@@ -139,7 +139,7 @@ struct Target {
 	int filter_score;
 	double filter_evalue;
 	int ungapped_score;
-	std::array<std::list<Hsp>, MAX_CONTEXT> hsp;
+	std::array<HspList, MAX_CONTEXT> hsp;
 	Stats::TargetMatrix matrix;
 };
 
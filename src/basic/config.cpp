@@ -42,6 +42,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../dp/dp.h"
 #include "masking.h"
 #include "../util/system/system.h"
+#include "../util/system/numa.h"
+#include "../util/memory/huge_pages.h"
 #include "../util/simd.h"
 #include "../util/parallel/multiprocessing.h"
 
@@ -114,6 +116,9 @@ Config::Config(int argc, const char **argv, bool check_io)
 {
 	Command_line_parser parser;
 	parser.add_command("makedb", "Build DIAMOND database from a FASTA file", makedb)
+		.add_command("makeidx", "Build a seed index for a DIAMOND database file", makeidx)
+		.add_command("serve", "Keep a DIAMOND database loaded and align queries received on a Unix socket", serve)
+		.add_command("coordinator", "Coordinate the workers of a multiprocessing run (see --mp-coordinator)", coordinator)
 		.add_command("blastp", "Align amino acid query sequences against a protein reference database", blastp)
 		.add_command("blastx", "Align DNA query sequences against a protein reference database", blastx)
 		.add_command("view", "View DIAMOND alignment archive (DAA) formatted file", view)
@@ -216,7 +221,8 @@ Config::Config(int argc, const char **argv, bool check_io)
 		("in", 0, "input reference file in FASTA format", input_ref_file)
 		("taxonmap", 0, "protein accession to taxid mapping file", prot_accession2taxid)
 		("taxonnodes", 0, "taxonomy nodes.dmp from NCBI", nodesdmp)
-		("taxonnames", 0, "taxonomy names.dmp from NCBI", namesdmp);
+		("taxonnames", 0, "taxonomy names.dmp from NCBI", namesdmp)
+		("collapse-identical", 0, "store identical sequences once with all of their titles", collapse_identical);
 
 	Options_group cluster("");
 	cluster.add()
@@ -236,6 +242,10 @@ Config::Config(int argc, const char **argv, bool check_io)
 	Options_group aligner("Aligner options");
 	aligner.add()
 		("query", 'q', "input query file", query_file)
+		("socket", 0, "Unix socket to listen on (serve command)", socket_path)
+		("max-connections", 0, "maximum number of connections received at the same time (serve command, default=8)", serve_connections, 8u)
+		("max-request-size", 0, "maximum size of a received query file in GB (serve command, default=1)", serve_max_request, 1.0)
+		("request-timeout", 0, "time limit in seconds for receiving a query file and for each write of the output (serve command, default=60)", serve_timeout, 60u)
 		("strand", 0, "query strands to search (both/minus/plus)", query_strands, string("both"))
 		("un", 0, "file for unaligned queries", unaligned)
 		("al", 0, "file or aligned queries", aligned_file)
@@ -272,6 +282,7 @@ Config::Config(int argc, const char **argv, bool check_io)
 		("query-gencode", 0, "genetic code to use to translate query (see user manual)", query_gencode, 1u)
 		("salltitles", 0, "include full subject titles in DAA file", salltitles)
 		("sallseqid", 0, "include all subject ids in DAA file", sallseqid)
+		("expand-titles", 0, "report hits to collapsed database sequences once for each title", expand_titles)
 		("no-self-hits", 0, "suppress reporting of identical self hits", no_self_hits)
 		("taxonlist", 0, "restrict search to list of taxon ids (comma-separated)", taxonlist)
 		("taxon-exclude", 0, "exclude list of taxon ids (comma-separated)", taxon_exclude);
@@ -289,6 +300,7 @@ Config::Config(int argc, const char **argv, bool check_io)
 		("shape-mask", 0, "seed shapes", shape_mask)
 		("multiprocessing", 0, "enable distributed-memory parallel processing", multiprocessing)
 		("mp-init", 0, "initialize multiprocessing run", mp_init)
+		("mp-coordinator", 0, "address of the coordinator process for multiprocessing (host:port or Unix socket path)", mp_coordinator)
 		("ext-chunk-size", 0, "chunk size for adaptive ranking (default=auto)", ext_chunk_size)
 		("no-ranking", 0, "disable ranking heuristic", no_ranking)
 		("ext", 0, "Extension mode (banded-fast/banded-slow/full)", ext)
@@ -296,6 +308,7 @@ Config::Config(int argc, const char **argv, bool check_io)
 		("taxon-k", 0, "maximum number of targets to report per species", taxon_k, (uint64_t)0)
 		("range-cover", 0, "percentage of query range to be covered for range culling (default=50%)", query_range_cover, 50.0)
 		("dbsize", 0, "effective database size (in letters)", db_size)
+		("query-dedup", 0, "align identical query sequences only once", query_dedup)
 		("no-auto-append", 0, "disable auto appending of DAA and DMND file extensions", no_auto_append)
 		("xml-blord-format", 0, "Use gnl|BL_ORD_ID| style format in XML output", xml_blord_format)
 		("stop-match-score", 0, "Set the match score of stop codons against each other.", stop_match_score, 1)
@@ -312,6 +325,14 @@ Config::Config(int argc, const char **argv, bool check_io)
 		("target-indexed", 0, "", target_indexed)
 		("mmap-target-index", 0, "", mmap_target_index)
 		("save-target-index", 0, "", save_target_index)
+		("seed-index", 0, "use the prebuilt seed index of the database (see makeidx)", seed_index)
+		("huge-pages", 0, "back large seed arrays and sequence sets by huge pages", huge_pages)
+		("numa", 0, "bind threads to NUMA nodes by seed partition", numa)
+		("block-cache", 0, "directory for reference blocks shared by concurrent runs on one node (e.g. /dev/shm)", block_cache)
+		("compress-temp", 0, "compression for temporary files (0=none, 1=zlib)", compress_temp, 0u)
+		("ref-prefetch-memory", 0, "memory limit in GB for loading the next reference block in the background (default=auto, 0=disabled)", ref_prefetch_memory, -1.0)
+		("trace-pt-memory", 0, "memory limit in GB for keeping seed hits in memory instead of temporary files (default=auto, 0=disabled)", trace_pt_memory, -1.0)
+		("query-prefetch-memory", 0, "memory limit in GB for loading the next query block in the background (default=auto, 0=disabled)", query_prefetch_memory, -1.0)
 		("log-evalue-scale", 0, "", log_evalue_scale, 1.0/std::log(2.0));
 
 	Options_group view_options("View options");
@@ -503,6 +524,9 @@ Config::Config(int argc, const char **argv, bool check_io)
 	if (global_ranking_targets > 0 && (query_range_culling || taxon_k || multiprocessing || mp_init || (command == blastx) || comp_based_stats >= 2))
 		throw std::runtime_error("Global ranking is not supported in this mode.");
 
+	if (query_dedup && (frame_shift != 0 || global_ranking_targets > 0))
+		throw std::runtime_error("Option --query-dedup is not supported for frameshift alignment and global ranking.");
+
 	if (global_ranking_targets > 0) {
 		if (ext != "" && ext != "full")
 			throw std::runtime_error("Global ranking only supports full matrix extension.");
@@ -576,8 +600,19 @@ Config::Config(int argc, const char **argv, bool check_io)
 
 		switch (command) {
 		case Config::dbinfo:
+		case Config::makeidx:
+			if (database == "")
+				throw std::runtime_error("Missing parameter: database file (--db/-d)");
+			break;
+		case Config::serve:
 			if (database == "")
 				throw std::runtime_error("Missing parameter: database file (--db/-d)");
+			if (socket_path == "")
+				throw std::runtime_error("Missing parameter: socket path (--socket)");
+			break;
+		case Config::coordinator:
+			if (mp_coordinator == "")
+				throw std::runtime_error("Missing parameter: coordinator address (--mp-coordinator)");
 		}
 	}
 
@@ -644,10 +679,15 @@ Config::Config(int argc, const char **argv, bool check_io)
 	case Config::cluster:
 	case Config::regression_test:
 	case Config::compute_medoids:
+	case Config::makeidx:
+	case Config::serve:
 		message_stream << "#CPU threads: " << threads_ << endl;
 	default:
 		;
 	}
+	if (numa)
+		Numa::init();
+	Util::Memory::huge_pages = huge_pages;
 
 	switch (command) {
 	case Config::blastp:
@@ -660,6 +700,8 @@ Config::Config(int argc, const char **argv, bool check_io)
 	case Config::cluster:
 	case Config::regression_test:
 	case Config::compute_medoids:
+	case Config::makeidx:
+	case Config::serve:
 		if (frame_shift != 0 && command == Config::blastp)
 			throw std::runtime_error("Frameshift alignments are only supported for translated searches.");
 		if (query_range_culling && frame_shift == 0)
@@ -693,7 +735,8 @@ Config::Config(int argc, const char **argv, bool check_io)
 	}
 
 	if (command == Config::blastp || command == Config::blastx || command == Config::benchmark || command == Config::model_sim || command == Config::opt
-		|| command == Config::mask || command == Config::cluster || command == Config::compute_medoids || command == Config::regression_test) {
+		|| command == Config::mask || command == Config::cluster || command == Config::compute_medoids || command == Config::regression_test || command == Config::makeidx
+		|| command == Config::serve) {
 		if (tmpdir == "")
 			tmpdir = extract_dir(output_file);
 
@@ -754,6 +797,12 @@ Config::Config(int argc, const char **argv, bool check_io)
 	if (mmap_target_index && save_target_index)
 		throw std::runtime_error("Options are exclusive.");
 
+	if (seed_index && (multiprocessing || target_indexed))
+		throw std::runtime_error("--seed-index is not supported in this mode.");
+
+	if (!block_cache.empty() && multiprocessing)
+		throw std::runtime_error("--block-cache is not supported in this mode.");
+
 	if (target_indexed && lowmem != 1)
 		throw std::runtime_error("--target-indexed requires -c1.");
 
@@ -39,6 +39,10 @@ struct Config
 	unsigned	threads_;
 	string	database;
 	string_vector query_file;
+	string socket_path;
+	unsigned serve_connections;
+	double serve_max_request;
+	unsigned serve_timeout;
 	unsigned	merge_seq_treshold;
 	unsigned	hit_cap;
 	unsigned shapes;
@@ -139,6 +143,8 @@ struct Config
 	bool hashed_seeds;
 	string nodesdmp;
 	bool sallseqid;
+	bool collapse_identical;
+	bool expand_titles;
 	string query_strands;
 	bool xml_blord_format;
 	int frame_shift;
@@ -256,6 +262,15 @@ struct Config
 	size_t deque_bucket_size;
 	bool mmap_target_index;
 	bool save_target_index;
+	bool seed_index;
+	string block_cache;
+	string mp_coordinator;
+	bool numa;
+	bool huge_pages;
+	double ref_prefetch_memory;
+	double trace_pt_memory;
+	double query_prefetch_memory;
+	bool query_dedup;
 	bool mode_fast;
 	double log_evalue_scale;
 	double ungapped_evalue_short;
@@ -270,7 +285,7 @@ struct Config
 		makedb = 0, blastp = 1, blastx = 2, view = 3, help = 4, version = 5, getseq = 6, benchmark = 7, random_seqs = 8, compare = 9, sort = 10, roc = 11, db_stat = 12, model_sim = 13,
 		match_file_stat = 14, model_seqs = 15, opt = 16, mask = 17, fastq2fasta = 18, dbinfo = 19, test_extra = 20, test_io = 21, db_annot_stats = 22, read_sim = 23, info = 24, seed_stat = 25,
 		smith_waterman = 26, cluster = 27, translate = 28, filter_blasttab = 29, show_cbs = 30, simulate_seqs = 31, split = 32, upgma = 33, upgma_mc = 34, regression_test = 35,
-		reverse_seqs = 36, compute_medoids = 37, mutate = 38, merge_tsv = 39, rocid = 40
+		reverse_seqs = 36, compute_medoids = 37, mutate = 38, merge_tsv = 39, rocid = 40, makeidx = 41, serve = 42, coordinator = 43
 	};
 	unsigned	command;
 
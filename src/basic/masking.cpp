@@ -18,11 +18,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <math.h>
 #include <algorithm>
-#include <atomic>
 #include "masking.h"
 #include "../lib/tantan/LambdaCalculator.hh"
 #include "../util/tantan.h"
 #include "../lib/blast/blast_filter.h"
+#include "../util/parallel/thread_pool.h"
+#include "../util/algo/MurmurHash3.h"
+#include "config.h"
 
 using namespace std;
 
@@ -51,6 +53,13 @@ Masking::Masking(const Score_matrix &score_matrix)
 	}
 	std::copy(likelihoodRatioMatrixf_, likelihoodRatioMatrixf_ + size, probMatrixPointersf_);
 
+	uint64_t h[2] = { 0, 0 };
+	for (size_t i = 0; i < n; ++i)
+		MurmurHash3_x64_128(likelihoodRatioMatrixf_[i], int(n * sizeof(float)), (const char*)h, h);
+	const double min_mask_prob = config.tantan_minMaskProb;
+	MurmurHash3_x64_128(&min_mask_prob, sizeof(min_mask_prob), (const char*)h, h);
+	fingerprint_ = h[0] | 1;
+
 	blast_seg_ = SegParametersNewAa();
 }
 
@@ -85,40 +94,37 @@ void Masking::mask_bit(Letter *seq, size_t len) const
 	Util::tantan::mask(seq, (int)len, (const float**)probMatrixPointersf_, 0.005f, 0.05f, 1.0f / 0.9f, (float)config.tantan_minMaskProb, mask_table_bit_);
 }
 
+// Both passes are written without branches so that the compiler can vectorize them.
 void Masking::bit_to_hard_mask(Letter *seq, size_t len, size_t &n) const
 {
-	for (size_t i = 0; i < len; ++i)
-		if (seq[i] & bit_mask) {
-			seq[i] = value_traits.mask_char;
-			++n;
-		}
+	const Letter mask_char = value_traits.mask_char;
+	size_t m = 0;
+	for (size_t i = 0; i < len; ++i) {
+		const Letter l = seq[i];
+		const bool masked = (l & bit_mask) != 0;
+		seq[i] = masked ? mask_char : l;
+		m += masked;
+	}
+	n += m;
 }
 
 void Masking::remove_bit_mask(Letter *seq, size_t len) const
 {
 	for (size_t i = 0; i < len; ++i)
-		if (seq[i] & bit_mask)
-			seq[i] &= ~bit_mask;
+		seq[i] &= ~bit_mask;
 }
 
-void mask_worker(atomic<size_t> *next, Sequence_set *seqs, const Masking *masking, bool hard_mask, Masking::Algo algo)
+void mask_worker(size_t i, size_t thread_id, Sequence_set *seqs, const Masking *masking, bool hard_mask, Masking::Algo algo)
 {
-	size_t i;
-	while ((i = (*next)++) < seqs->get_length())
-		if (hard_mask)
-			masking->operator()(seqs->ptr(i), seqs->length(i), algo);
-		else
-			masking->mask_bit(seqs->ptr(i), seqs->length(i));
+	if (hard_mask)
+		masking->operator()(seqs->ptr(i), seqs->length(i), algo);
+	else
+		masking->mask_bit(seqs->ptr(i), seqs->length(i));
 }
 
 size_t mask_seqs(Sequence_set &seqs, const Masking &masking, bool hard_mask, Masking::Algo algo)
 {
-	vector<thread> threads;
-	atomic<size_t> next(0);
-	for (size_t i = 0; i < config.threads_; ++i)
-		threads.emplace_back(mask_worker, &next, &seqs, &masking, hard_mask, algo);
-	for (auto &t : threads)
-		t.join();
+	Util::Parallel::scheduled_thread_pool_auto(config.threads_, seqs.get_length(), mask_worker, &seqs, &masking, hard_mask, algo);
 	size_t n = 0;
 	for (size_t i = 0; i < seqs.get_length(); ++i)
 		n += std::count(seqs[i].data(), seqs[i].end(), value_traits.mask_char);
@@ -34,6 +34,12 @@ struct Masking
 	void mask_bit(Letter *seq, size_t len) const;
 	void bit_to_hard_mask(Letter *seq, size_t len, size_t &n) const;
 	void remove_bit_mask(Letter *seq, size_t len) const;
+	// Identifies the tantan parameters, so that a soft mask stored in a
+	// database can be checked against the current settings.
+	uint64_t fingerprint() const
+	{
+		return fingerprint_;
+	}
 	static const Masking& get()
 	{
 		return *instance;
@@ -44,6 +50,7 @@ private:
 	enum { size = 64 };
 	float likelihoodRatioMatrixf_[size][size], *probMatrixPointersf_[size];
 	Letter mask_table_x_[size], mask_table_bit_[size];
+	uint64_t fingerprint_;
 	SegParameters* blast_seg_;
 };
 
@@ -34,6 +34,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../stats/score_matrix.h"
 #include "translated_position.h"
 #include "diagonal_segment.h"
+#include "../util/memory/arena.h"
 
 inline interval normalized_range(unsigned pos, int len, Strand strand)
 {
@@ -43,6 +44,10 @@ inline interval normalized_range(unsigned pos, int len, Strand strand)
 }
 
 struct IntermediateRecord;
+struct Hsp;
+
+// HSP nodes are allocated from the per-query arena of the align thread.
+typedef std::list<Hsp, Util::Memory::ArenaAllocator<Hsp>> HspList;
 
 struct Hsp
 {
@@ -208,8 +213,8 @@ struct Hsp
 	}
 
 	bool is_enveloped_by(const Hsp &hsp, double p) const;
-	bool is_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, double p) const;
-	bool is_weakly_enveloped_by(std::list<Hsp>::const_iterator begin, std::list<Hsp>::const_iterator end, int cutoff) const;
+	bool is_enveloped_by(HspList::const_iterator begin, HspList::const_iterator end, double p) const;
+	bool is_weakly_enveloped_by(HspList::const_iterator begin, HspList::const_iterator end, int cutoff) const;
 	void push_back(const DiagonalSegment &d, const TranslatedSequence &query, const sequence &subject, bool reversed);
 	void push_match(Letter q, Letter s, bool positive);
 	void push_gap(Edit_operation op, int length, const Letter *subject);
@@ -37,7 +37,7 @@ struct Statistics
 		SEARCH_TEMP_SPACE, SECONDARY_HITS, ERASED_HITS, SQUARED_ERROR, CELLS, TARGET_HITS0, TARGET_HITS1, TARGET_HITS2, TARGET_HITS3, TARGET_HITS3_CBS, TARGET_HITS4, TARGET_HITS5, TIME_GREEDY_EXT, LOW_COMPLEXITY_SEEDS,
 		SWIPE_REALIGN, EXT8, EXT16, EXT32, GAPPED_FILTER_TARGETS, GAPPED_FILTER_HITS1, GAPPED_FILTER_HITS2, GROSS_DP_CELLS, NET_DP_CELLS, TIME_TARGET_SORT, TIME_SW, TIME_EXT, TIME_GAPPED_FILTER,
 		TIME_LOAD_HIT_TARGETS, TIME_CHAINING, TIME_LOAD_SEED_HITS, TIME_SORT_SEED_HITS, TIME_SORT_TARGETS_BY_SCORE, TIME_TARGET_PARALLEL, TIME_TRACEBACK_SW, TIME_TRACEBACK, HARD_QUERIES, TIME_MATRIX_ADJUST,
-		MATRIX_ADJUST_COUNT, COUNT
+		MATRIX_ADJUST_COUNT, SEARCH_TEMP_SPACE_RAW, NUMA_PARTITIONS, NUMA_REMOTE_PARTITIONS, COUNT
 	};
 
 	Statistics()
@@ -125,7 +125,12 @@ struct Statistics
 		//log_stream << "Gapped matches = " << data_[GAPPED] << endl;
 		//log_stream << "MSE = " << (double)data_[SQUARED_ERROR] / (double)data_[OUT_HITS] << endl;
 		//log_stream << "Cells = " << data_[CELLS] << endl;
-		verbose_stream << "Temporary disk space used (search): " << (double)data_[SEARCH_TEMP_SPACE] / (1 << 30) << " GB" << endl;
+		if (data_[NUMA_PARTITIONS] > 0)
+			verbose_stream << "Seed partitions searched on a remote NUMA node: " << data_[NUMA_REMOTE_PARTITIONS] << " (" << data_[NUMA_REMOTE_PARTITIONS] * 100.0 / data_[NUMA_PARTITIONS] << "%)" << endl;
+		verbose_stream << "Temporary disk space used (search): " << (double)data_[SEARCH_TEMP_SPACE] / (1 << 30) << " GB";
+		if (data_[SEARCH_TEMP_SPACE_RAW] != data_[SEARCH_TEMP_SPACE])
+			verbose_stream << " (" << (double)data_[SEARCH_TEMP_SPACE_RAW] / (1 << 30) << " GB uncompressed)";
+		verbose_stream << endl;
 		message_stream << "Reported " << data_[PAIRWISE] << " pairwise alignments, " << data_[MATCHES] << " HSPs." << endl;
 		message_stream << data_[ALIGNED] << " queries aligned." << endl;
 	}
@@ -38,7 +38,7 @@ using std::map;
 using std::list;
 using std::set;
 
-bool disjoint(list<Hsp_traits>::const_iterator begin, list<Hsp_traits>::const_iterator end, const Hsp_traits &t, int cutoff)
+bool disjoint(HspTraitsList::const_iterator begin, HspTraitsList::const_iterator end, const Hsp_traits &t, int cutoff)
 {
 	for (; begin != end; ++begin)
 		if (begin->partial_score(t) < cutoff || !begin->collinear(t))
@@ -48,7 +48,7 @@ bool disjoint(list<Hsp_traits>::const_iterator begin, list<Hsp_traits>::const_it
 	return true;
 }
 
-bool disjoint(list<Hsp_traits>::const_iterator begin, list<Hsp_traits>::const_iterator end, const Diagonal_segment &d, int cutoff)
+bool disjoint(HspTraitsList::const_iterator begin, HspTraitsList::const_iterator end, const Diagonal_segment &d, int cutoff)
 {
 	for (; begin != end; ++begin)
 		if (begin->partial_score(d) < cutoff || !begin->collinear(d))
@@ -490,7 +490,7 @@ struct Greedy_aligner2
 		t = traits;
 	}
 
-	int backtrace(size_t top_node, list<Hsp> &hsps, list<Hsp_traits> &ts, list<Hsp_traits>::iterator &t_begin, int cutoff, int max_shift) const
+	int backtrace(size_t top_node, HspList &hsps, HspTraitsList &ts, HspTraitsList::iterator &t_begin, int cutoff, int max_shift) const
 	{
 		unsigned next;
 		int max_score = 0, max_j = (int)subject.length();
@@ -519,7 +519,7 @@ struct Greedy_aligner2
 		return max_score;
 	}
 
-	int backtrace(list<Hsp> &hsps, list<Hsp_traits> &ts, int cutoff, int max_shift) const
+	int backtrace(HspList &hsps, HspTraitsList &ts, int cutoff, int max_shift) const
 	{
 		vector<Diagonal_node*> top_nodes;
 		for (size_t i = 0; i < diags.nodes.size(); ++i) {
@@ -531,7 +531,7 @@ struct Greedy_aligner2
 		}
 		std::sort(top_nodes.begin(), top_nodes.end(), Diagonal_node::cmp_rel_score);
 		int max_score = 0;
-		list<Hsp_traits>::iterator t_begin = ts.end();
+		HspTraitsList::iterator t_begin = ts.end();
 
 		for (vector<Diagonal_node*>::const_iterator i = top_nodes.begin(); i < top_nodes.end(); ++i) {
 			const size_t node = *i - diags.nodes.data();
@@ -548,7 +548,7 @@ struct Greedy_aligner2
 		return max_score;
 	}
 
-	int run(list<Hsp> &hsps, list<Hsp_traits> &ts, double space_penalty, int cutoff, int max_shift)
+	int run(HspList &hsps, HspTraitsList &ts, double space_penalty, int cutoff, int max_shift)
 	{
 		if (config.chaining_maxnodes > 0) {
 			std::sort(diags.nodes.begin(), diags.nodes.end(), Diagonal_segment::cmp_score);
@@ -578,7 +578,7 @@ struct Greedy_aligner2
 
 		if (log) {
 			hsps.sort(Hsp::cmp_query_pos);
-			for (list<Hsp>::iterator i = hsps.begin(); i != hsps.end(); ++i)
+			for (HspList::iterator i = hsps.begin(); i != hsps.end(); ++i)
 				print_hsp(*i, TranslatedSequence(query));
 			cout << endl << "Smith-Waterman:" << endl;
 			smith_waterman(query, subject, diags);
@@ -587,7 +587,7 @@ struct Greedy_aligner2
 		return max_score;
 	}
 
-	int run(list<Hsp> &hsps, list<Hsp_traits> &ts, vector<Diagonal_segment>::const_iterator begin, vector<Diagonal_segment>::const_iterator end, int band)
+	int run(HspList &hsps, HspTraitsList &ts, vector<Diagonal_segment>::const_iterator begin, vector<Diagonal_segment>::const_iterator end, int band)
 	{
 		if (log)
 			cout << "***** Seed hit run " << begin->diag() << '\t' << (end - 1)->diag() << '\t' << (end - 1)->diag() - begin->diag() << endl;
@@ -617,14 +617,14 @@ struct Greedy_aligner2
 thread_local Diag_graph Greedy_aligner2::diags;
 thread_local map<int, unsigned> Greedy_aligner2::window;
 
-std::pair<int, list<Hsp_traits>> greedy_align(sequence query, sequence subject, vector<Diagonal_segment>::const_iterator begin, vector<Diagonal_segment>::const_iterator end, bool log, unsigned frame)
+std::pair<int, HspTraitsList> greedy_align(sequence query, sequence subject, vector<Diagonal_segment>::const_iterator begin, vector<Diagonal_segment>::const_iterator end, bool log, unsigned frame)
 {
 	const int band = config.chaining_maxgap;
 	if (end - begin == 1)
 		return { begin->score, { { begin->diag(), begin->diag(), begin->score, (int)frame, begin->query_range(), begin->subject_range() } } };
 	Greedy_aligner2 ga(query, subject, log, frame);
-	list<Hsp> hsps;
-	list<Hsp_traits> ts;
+	HspList hsps;
+	HspTraitsList ts;
 	int score = ga.run(hsps, ts, begin, end, band);
 	return std::make_pair(score, std::move(ts));
 }
\ No newline at end of file
@@ -52,6 +52,7 @@ vector<int> MultiStep::cluster(DatabaseFile& db, const BitVector* filter) {
 	Workflow::Search::Options opt;
 	opt.db = &db;
 	opt.self = true;
+	opt.symmetric = true;
 	Neighbors nb(db.ref_header.sequences);
 
 	opt.consumer = &nb;
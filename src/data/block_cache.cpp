@@ -0,0 +1,176 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <stdio.h>
+#include <tuple>
+#include <memory>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+#include "block_cache.h"
+#include "reference.h"
+#include "../basic/config.h"
+#include "../basic/masking.h"
+#include "../util/io/output_file.h"
+#include "../util/parallel/multiprocessing.h"
+#include "../util/system/system.h"
+#include "../util/log_stream.h"
+#include "../util/util.h"
+
+using std::string;
+using std::vector;
+using std::endl;
+using std::to_string;
+
+namespace BlockCache {
+
+static size_t aligned(size_t n)
+{
+	return (n + 7) & ~(size_t)7;
+}
+
+string file_name(const DatabaseFile &db_file, size_t begin_seq, size_t max_letters, bool mask)
+{
+	const uint64_t mask_key = mask ? Masking::get().fingerprint() : 0;
+	return join_path(config.block_cache, hex_print(db_file.header2.hash, sizeof(db_file.header2.hash))
+		+ '_' + to_string(begin_seq) + '_' + to_string(max_letters) + '_' + to_string(mask_key) + ".blk");
+}
+
+static void write_padding(OutputFile &out, size_t n)
+{
+	static const char zero[8] = { 0 };
+	out.write(zero, aligned(n) - n);
+}
+
+// The file is written under a temporary name and renamed, so that other
+// processes never map a partial block.
+static void save(const string &file_name, const DatabaseFile &db_file, size_t begin_seq, const vector<uint32_t> &block2db_id, const Sequence_set &seqs, const String_set<char, 0> &ids)
+{
+	task_timer timer("Writing reference block to cache");
+	Header h;
+	h.magic_number = Header::MAGIC_NUMBER;
+	h.version = Header::CURRENT_VERSION;
+	h.db_letters = db_file.ref_header.letters;
+	h.begin_seq = begin_seq;
+	h.end_seq = db_file.tell_seq();
+	h.seqs = seqs.get_length();
+	h.seq_raw_len = seqs.raw_len() + Sequence_set::PERIMETER_PADDING;
+	h.id_raw_len = ids.raw_len() + String_set<char, 0>::PERIMETER_PADDING;
+
+	const string tmp_name = file_name + ".tmp" + to_string(getpid());
+	OutputFile out(tmp_name);
+	try {
+		out.write(h);
+		out.write(seqs.limits_begin(), h.seqs + 1);
+		out.write(seqs.data(), h.seq_raw_len);
+		write_padding(out, h.seq_raw_len);
+		out.write(ids.limits_begin(), h.seqs + 1);
+		out.write(ids.data(), h.id_raw_len);
+		write_padding(out, h.id_raw_len);
+		out.write(block2db_id.data(), block2db_id.size());
+		out.close();
+	}
+	catch (std::exception&) {
+		out.close();
+		out.remove();
+		throw;
+	}
+	if (rename(tmp_name.c_str(), file_name.c_str()) != 0) {
+		remove(tmp_name.c_str());
+		throw std::runtime_error("Error writing block cache file " + file_name);
+	}
+}
+
+static bool attach(const string &file_name, DatabaseFile &db_file, size_t begin_seq, vector<uint32_t> &block2db_id, Sequence_set **seqs, String_set<char, 0> **ids)
+{
+	char *ptr;
+	size_t size;
+	int fd;
+	std::tie(ptr, size, fd) = mmap_file(file_name.c_str(), true);
+	if (ptr == nullptr)
+		return false;
+	std::shared_ptr<void> storage(ptr, [size, fd](void *p) { unmap_file((char*)p, size, fd); });
+
+	const Header *h = (const Header*)ptr;
+	if (size < sizeof(Header) || h->magic_number != Header::MAGIC_NUMBER || h->version != Header::CURRENT_VERSION
+		|| h->db_letters != db_file.ref_header.letters || h->begin_seq != begin_seq)
+		throw std::runtime_error("Invalid block cache file: " + file_name);
+
+	const size_t limits_size = (h->seqs + 1) * sizeof(size_t),
+		seq_offset = sizeof(Header),
+		id_offset = seq_offset + limits_size + aligned(h->seq_raw_len),
+		block2db_offset = id_offset + limits_size + aligned(h->id_raw_len);
+	if (size != block2db_offset + h->seqs * sizeof(uint32_t))
+		throw std::runtime_error("Invalid block cache file: " + file_name);
+
+	*seqs = new Sequence_set((Letter*)(ptr + seq_offset + limits_size), (const size_t*)(ptr + seq_offset), h->seqs, storage);
+	*ids = new String_set<char, 0>(ptr + id_offset + limits_size, (const size_t*)(ptr + id_offset), h->seqs, storage);
+	const uint32_t *block2db = (const uint32_t*)(ptr + block2db_offset);
+	block2db_id.assign(block2db, block2db + h->seqs);
+
+	db_file.seek_seq(h->end_seq);
+	if (config.multiprocessing || config.global_ranking_targets)
+		blocked_processing = true;
+	else
+		blocked_processing = h->end_seq - h->begin_seq < db_file.ref_header.sequences;
+	return true;
+}
+
+bool load(DatabaseFile &db_file, size_t max_letters, bool mask, vector<uint32_t> &block2db_id, Sequence_set **seqs, String_set<char, 0> **ids)
+{
+	const size_t begin_seq = db_file.tell_seq();
+	if (begin_seq >= db_file.ref_header.sequences)
+		return false;
+	const string name = file_name(db_file, begin_seq, max_letters, mask);
+	task_timer timer;
+	if (exists(name)) {
+		timer.go("Loading reference sequences from cache");
+		if (attach(name, db_file, begin_seq, block2db_id, seqs, ids)) {
+			timer.finish();
+			(*seqs)->print_stats();
+			return true;
+		}
+		timer.finish();
+	}
+
+	const bool mask_on_load = mask && db_file.soft_masked();
+	if (!db_file.load_seqs(&block2db_id, max_letters, seqs, ids, true, nullptr, true, Chunk(), true, mask_on_load))
+		return false;
+	if (mask && !mask_on_load) {
+		timer.go("Masking reference");
+		const size_t n = mask_seqs(**seqs, Masking::get());
+		timer.finish();
+		log_stream << "Masked letters: " << n << endl;
+	}
+	save(name, db_file, begin_seq, block2db_id, **seqs, **ids);
+
+	// Replace the private copy by the shared mapping.
+	delete *seqs;
+	delete *ids;
+	if (!attach(name, db_file, begin_seq, block2db_id, seqs, ids))
+		throw std::runtime_error("Error memory mapping file " + name);
+	return true;
+}
+
+}
@@ -0,0 +1,47 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "sequence_set.h"
+
+struct DatabaseFile;
+
+// Decoded and masked reference blocks stored as files in a cache directory
+// (e.g. /dev/shm) and memory mapped by every process that searches the same
+// block, so that concurrent runs on one node share a single copy.
+namespace BlockCache {
+
+struct Header
+{
+	uint64_t magic_number, version, db_letters, begin_seq, end_seq, seqs, seq_raw_len, id_raw_len;
+	enum { CURRENT_VERSION = 0 };
+	static constexpr uint64_t MAGIC_NUMBER = 0x5b1e7cd2a9f04e63llu;
+};
+
+std::string file_name(const DatabaseFile &db_file, size_t begin_seq, size_t max_letters, bool mask);
+// Loads the reference block starting at the current position of the database
+// file, like DatabaseFile::load_seqs without a filter. The block is masked if
+// mask is set.
+bool load(DatabaseFile &db_file, size_t max_letters, bool mask, std::vector<uint32_t> &block2db_id, Sequence_set **seqs, String_set<char, 0> **ids);
+
+}
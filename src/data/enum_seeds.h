@@ -1,13 +1,16 @@
 #pragma once
 
 #include "sequence_set.h"
+#include "../util/parallel/thread_pool.h"
 
+// Sequences i with (*skip)[i] set are left out.
 template<typename _f, typename _filter>
-void enum_seeds(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter)
+void enum_seeds(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter, const std::vector<bool>* skip)
 {
 	vector<Letter> buf(seqs->max_len(begin, end));
 	uint64_t key;
 	for (unsigned i = begin; i < end; ++i) {
+		if (skip && (*skip)[i]) continue;
 		const sequence seq = (*seqs)[i];
 		Reduction::reduce_seq(seq, buf);
 		for (size_t shape_id = shape_range.first; shape_id < shape_range.second; ++shape_id) {
@@ -27,10 +30,11 @@ void enum_seeds(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, s
 }
 
 template<typename _f, uint64_t _b, typename _filter>
-void enum_seeds_hashed(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter)
+void enum_seeds_hashed(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter, const std::vector<bool>* skip)
 {
 	uint64_t key;
 	for (unsigned i = begin; i < end; ++i) {
+		if (skip && (*skip)[i]) continue;
 		const sequence seq = (*seqs)[i];
 		for (size_t shape_id = shape_range.first; shape_id < shape_range.second; ++shape_id) {
 			const Shape& sh = shapes[shape_id];
@@ -50,10 +54,11 @@ void enum_seeds_hashed(const Sequence_set* seqs, _f* f, unsigned begin, unsigned
 }
 
 template<typename _f, typename _it, typename _filter>
-void enum_seeds_contiguous(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, const _filter* filter)
+void enum_seeds_contiguous(const Sequence_set* seqs, _f* f, unsigned begin, unsigned end, const _filter* filter, const std::vector<bool>* skip)
 {
 	uint64_t key;
 	for (unsigned i = begin; i < end; ++i) {
+		if (skip && (*skip)[i]) continue;
 		const sequence seq = (*seqs)[i];
 		if (seq.length() < _it::length()) continue;
 		_it it(seq);
@@ -70,7 +75,7 @@ void enum_seeds_contiguous(const Sequence_set* seqs, _f* f, unsigned begin, unsi
 }
 
 template<typename _f, typename _filter>
-static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter, bool contig)
+static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, unsigned end, std::pair<size_t, size_t> shape_range, const _filter* filter, bool contig, const std::vector<bool>* skip)
 {
 	static const char* errmsg = "Unsupported contiguous seed.";
 	if (shape_range.second - shape_range.first == 1 && shapes[shape_range.first].contiguous() && shapes.count() == 1 && (config.algo == Config::query_indexed || contig)) {
@@ -79,7 +84,7 @@ static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, u
 		case 7:
 			switch (b) {
 			case 4:
-				enum_seeds_contiguous<_f, Contiguous_seed_iterator<7, 4>, _filter>(seqs, f, begin, end, filter);
+				enum_seeds_contiguous<_f, Contiguous_seed_iterator<7, 4>, _filter>(seqs, f, begin, end, filter, skip);
 				break;
 			default:
 				throw std::runtime_error(errmsg);
@@ -88,7 +93,7 @@ static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, u
 		case 6:
 			switch (b) {
 			case 4:
-				enum_seeds_contiguous<_f, Contiguous_seed_iterator<6, 4>, _filter>(seqs, f, begin, end, filter);
+				enum_seeds_contiguous<_f, Contiguous_seed_iterator<6, 4>, _filter>(seqs, f, begin, end, filter, skip);
 				break;
 			default:
 				throw std::runtime_error(errmsg);
@@ -97,7 +102,7 @@ static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, u
 		case 5:
 			switch (b) {
 			case 4:
-				enum_seeds_contiguous<_f, Contiguous_seed_iterator<5, 4>, _filter>(seqs, f, begin, end, filter);
+				enum_seeds_contiguous<_f, Contiguous_seed_iterator<5, 4>, _filter>(seqs, f, begin, end, filter, skip);
 				break;
 			default:
 				throw std::runtime_error(errmsg);
@@ -111,14 +116,14 @@ static void enum_seeds_worker(_f* f, const Sequence_set* seqs, unsigned begin, u
 		const uint64_t b = Reduction::reduction.bit_size();
 		switch (b) {
 		case 4:
-			enum_seeds_hashed<_f, 4, _filter>(seqs, f, begin, end, shape_range, filter);
+			enum_seeds_hashed<_f, 4, _filter>(seqs, f, begin, end, shape_range, filter, skip);
 			break;
 		default:
 			throw std::runtime_error("Unsupported reduction.");
 		}
 	}
 	else
-		enum_seeds<_f, _filter>(seqs, f, begin, end, shape_range, filter);
+		enum_seeds<_f, _filter>(seqs, f, begin, end, shape_range, filter, skip);
 }
 
 struct No_filter
@@ -132,11 +137,9 @@ struct No_filter
 extern No_filter no_filter;
 
 template <typename _f, typename _filter>
-void enum_seeds(const Sequence_set* seqs, PtrVector<_f>& f, const std::vector<size_t>& p, size_t shape_begin, size_t shape_end, const _filter* filter, bool contig = false)
+void enum_seeds(const Sequence_set* seqs, PtrVector<_f>& f, const std::vector<size_t>& p, size_t shape_begin, size_t shape_end, const _filter* filter, bool contig = false, const std::vector<bool>* skip = nullptr)
 {
-	std::vector<std::thread> threads;
-	for (unsigned i = 0; i < f.size(); ++i)
-		threads.emplace_back(enum_seeds_worker<_f, _filter>, &f[i], seqs, (unsigned)p[i], (unsigned)p[i + 1], std::make_pair(shape_begin, shape_end), filter, contig);
-	for (auto& t : threads)
-		t.join();
+	Util::Parallel::ThreadPool::get().run(f.size(), f.size(), [&](size_t i, size_t) {
+		enum_seeds_worker<_f, _filter>(&f[i], seqs, (unsigned)p[i], (unsigned)p[i + 1], std::make_pair(shape_begin, shape_end), filter, contig, skip);
+	});
 }
\ No newline at end of file
@@ -21,29 +21,37 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <numeric>
 #include <utility>
-#include <atomic>
 #include "frequent_seeds.h"
 #include "queries.h"
 #include "../util/parallel/thread_pool.h"
 
 using std::endl;
-using std::atomic;
 
 const double Frequent_seeds::hash_table_factor = 1.3;
 Frequent_seeds frequent_seeds;
 
-void Frequent_seeds::compute_sd(atomic<unsigned> *seedp, DoubleArray<SeedArray::_pos> *query_seed_hits, DoubleArray<SeedArray::_pos> *ref_seed_hits, vector<Sd> *ref_out, vector<Sd> *query_out)
+// Seed frequencies count hidden duplicate queries as if they were searched, so
+// that query deduplication does not change the frequency caps.
+static size_t query_seed_count(const Range<SeedArray::_pos*> &hits)
 {
-	unsigned p;
-	while ((p = (*seedp)++) < current_range.end()) {
-		Sd ref_sd, query_sd;
-		for (auto it = JoinIterator<SeedArray::_pos>(query_seed_hits[p].begin(), ref_seed_hits[p].begin()); it; ++it) {
-			query_sd.add((double)it.r->size());
-			ref_sd.add((double)it.s->size());
-		}
-		(*ref_out)[p - current_range.begin()] = ref_sd;
-		(*query_out)[p - current_range.begin()] = query_sd;
+	if (!query_dedup)
+		return hits.size();
+	size_t n = 0;
+	for (const SeedArray::_pos* i = hits.begin(); i < hits.end(); ++i)
+		n += query_dedup->multiplicity(query_seqs::get().local_position((uint64_t)*i).first / align_mode.query_contexts);
+	return n;
+}
+
+void Frequent_seeds::compute_sd(size_t i, size_t thread_id, DoubleArray<SeedArray::_pos> *query_seed_hits, DoubleArray<SeedArray::_pos> *ref_seed_hits, vector<Sd> *ref_out, vector<Sd> *query_out)
+{
+	const size_t p = current_range.begin() + i;
+	Sd ref_sd, query_sd;
+	for (auto it = JoinIterator<SeedArray::_pos>(query_seed_hits[p].begin(), ref_seed_hits[p].begin()); it; ++it) {
+		query_sd.add((double)query_seed_count(*it.r));
+		ref_sd.add((double)it.s->size());
 	}
+	(*ref_out)[i] = ref_sd;
+	(*query_out)[i] = query_sd;
 }
 
 void Frequent_seeds::build_worker(
@@ -62,7 +70,7 @@ void Frequent_seeds::build_worker(
 	vector<uint32_t> buf;
 	size_t n = 0;
 	for (auto it = JoinIterator<SeedArray::_pos>(query_seed_hits[seedp].begin(), ref_seed_hits[seedp].begin()); it;) {
-		if (it.s->size() > ref_max_n || it.r->size() > query_max_n) {
+		if (it.s->size() > ref_max_n || query_seed_count(*it.r) > query_max_n) {
 			n += (unsigned)it.s->size();
 			//Packed_seed s;
 			//shapes[sid].set_seed(s, query_seqs::get().data(*it.r->begin()));
@@ -87,12 +95,7 @@ void Frequent_seeds::build_worker(
 void Frequent_seeds::build(unsigned sid, const SeedPartitionRange &range, DoubleArray<SeedArray::_pos> *query_seed_hits, DoubleArray<SeedArray::_pos> *ref_seed_hits)
 {
 	vector<Sd> ref_sds(range.size()), query_sds(range.size());
-	atomic<unsigned> seedp(range.begin());
-	vector<std::thread> threads;
-	for (unsigned i = 0; i < config.threads_; ++i)
-		threads.emplace_back(compute_sd, &seedp, query_seed_hits, ref_seed_hits, &ref_sds, &query_sds);
-	for (auto &t : threads)
-		t.join();
+	Util::Parallel::scheduled_thread_pool_auto(config.threads_, range.size(), compute_sd, query_seed_hits, ref_seed_hits, &ref_sds, &query_sds);
 
 	Sd ref_sd(ref_sds), query_sd(query_sds);
 	const unsigned ref_max_n = (unsigned)(ref_sd.mean() + config.freq_sd*ref_sd.sd()), query_max_n = (unsigned)(query_sd.mean() + config.freq_sd*query_sd.sd());
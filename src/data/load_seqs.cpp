@@ -0,0 +1,300 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <limits>
+#include <thread>
+#include <exception>
+#include "load_seqs.h"
+#include "../basic/config.h"
+#include "../util/task_queue.h"
+
+using std::string;
+using std::vector;
+using std::list;
+using std::thread;
+
+// Records are split from the input on a single thread. Letter conversion
+// and translation run on worker threads, and the batches are appended to
+// the sequence sets in input order.
+
+namespace {
+
+struct SeqRecord
+{
+	string id;
+	vector<char> raw, qual;
+	vector<Letter> seq, frames[6];
+	unsigned good_frames;
+	size_t line;
+};
+
+struct SeqBatch
+{
+	size_t size() const
+	{
+		return records.size();
+	}
+	vector<SeqRecord> records;
+	std::exception_ptr error;
+};
+
+struct SeqReader
+{
+
+	enum { BATCH_SIZE = 4096 };
+
+	SeqReader(list<TextInputFile>::iterator file_begin, list<TextInputFile>::iterator file_end, const Sequence_file_format &format, const string &filter, const Value_traits &value_traits, bool quals, size_t max_letters, size_t modulo) :
+		file_begin(file_begin),
+		file_end(file_end),
+		file_it(file_begin),
+		format(format),
+		filter(filter),
+		value_traits(value_traits),
+		quals(quals),
+		max_letters(max_letters),
+		modulo(modulo),
+		letters(0),
+		n(0),
+		read_success(true)
+	{}
+
+	// Number of letters the record will occupy in the sequence set.
+	size_t letter_count(size_t len) const
+	{
+		if (value_traits.seq_type == Sequence_type::amino_acid)
+			return len;
+		if (len < 2)
+			return 0;
+		return 2 * (len / 3 + (len - 1) / 3 + (len - 2) / 3);
+	}
+
+	bool operator()(vector<SeqRecord> &records)
+	{
+		records.clear();
+		if (error)
+			return false;
+		const size_t seqs_per_record = value_traits.seq_type == Sequence_type::amino_acid ? 1 : 6;
+		try {
+			while (records.size() < BATCH_SIZE) {
+				if (!(letters < max_letters || (n % modulo != 0)))
+					return false;
+				records.emplace_back();
+				SeqRecord &r = records.back();
+				r.line = file_it->line_count + 2;
+				if (!(read_success = format.get_raw_seq(r.id, r.raw, *file_it, value_traits, quals ? &r.qual : nullptr))) {
+					records.pop_back();
+					return false;
+				}
+				if (r.raw.size() > 0 && (filter.empty() || r.id.find(filter, 0) != string::npos)) {
+					letters += letter_count(r.raw.size());
+					++n;
+					if (n * seqs_per_record > (size_t)std::numeric_limits<int>::max())
+						throw std::runtime_error("Number of sequences in file exceeds supported maximum.");
+				}
+				else
+					records.pop_back();
+				++file_it;
+				if (file_it == file_end)
+					file_it = file_begin;
+			}
+		}
+		catch (...) {
+			error = std::current_exception();
+			return false;
+		}
+		return true;
+	}
+
+	const list<TextInputFile>::iterator file_begin, file_end;
+	list<TextInputFile>::iterator file_it;
+	const Sequence_file_format &format;
+	const string &filter;
+	const Value_traits &value_traits;
+	const bool quals;
+	const size_t max_letters, modulo;
+	size_t letters, n;
+	bool read_success;
+	std::exception_ptr error;
+
+};
+
+struct SeqFetcher
+{
+	SeqFetcher(SeqReader &reader) :
+		reader(reader)
+	{}
+	bool operator()()
+	{
+		return reader(records);
+	}
+	SeqReader &reader;
+	vector<SeqRecord> records;
+};
+
+struct SeqWriter
+{
+
+	SeqWriter(Sequence_set *seqs, String_set<char, '\0'> *ids, Sequence_set *source_seqs, String_set<char, '\0'> *quals, Sequence_type seq_type) :
+		seqs(seqs),
+		ids(ids),
+		source_seqs(source_seqs),
+		quals(quals),
+		seq_type(seq_type)
+	{}
+
+	void operator()(SeqBatch &batch)
+	{
+		if (batch.error && !error)
+			error = batch.error;
+		if (!error)
+			for (const SeqRecord &r : batch.records) {
+				ids->push_back(r.id.begin(), r.id.end());
+				if (seq_type == Sequence_type::amino_acid)
+					seqs->push_back(r.seq.cbegin(), r.seq.cend());
+				else {
+					source_seqs->push_back(r.seq.cbegin(), r.seq.cend());
+					if (r.seq.size() < 2) {
+						for (unsigned j = 0; j < 6; ++j)
+							seqs->fill(0, value_traits.mask_char);
+					}
+					else
+						for (unsigned j = 0; j < 6; ++j) {
+							if (r.good_frames & (1 << j))
+								seqs->push_back(r.frames[j].cbegin(), r.frames[j].cend());
+							else
+								seqs->fill(r.frames[j].size(), value_traits.mask_char);
+						}
+				}
+				if (quals)
+					quals->push_back(r.qual.begin(), r.qual.end());
+			}
+		batch.records.clear();
+		batch.error = nullptr;
+	}
+
+	Sequence_set *seqs;
+	String_set<char, '\0'> *ids;
+	Sequence_set *source_seqs;
+	String_set<char, '\0'> *quals;
+	const Sequence_type seq_type;
+	std::exception_ptr error;
+
+};
+
+typedef Task_queue<SeqBatch, SeqWriter> SeqQueue;
+
+void convert_seq(SeqRecord &r, const Value_traits &value_traits, unsigned frame_mask)
+{
+	r.seq.clear();
+	r.seq.reserve(r.raw.size());
+	try {
+		for (char c : r.raw)
+			r.seq.push_back(value_traits.from_char(c));
+	}
+	catch (invalid_sequence_char_exception &e) {
+		throw StreamReadException(r.line, e.what());
+	}
+	if (value_traits.seq_type == Sequence_type::nucleotide && r.seq.size() >= 2) {
+		Translator::translate(r.seq, r.frames);
+		r.good_frames = Translator::computeGoodFrames(r.frames, config.get_run_len((unsigned)r.seq.size() / 3)) & frame_mask;
+	}
+}
+
+void load_worker(SeqQueue *queue, SeqReader *reader, const Value_traits *value_traits, unsigned frame_mask)
+{
+	SeqFetcher fetcher(*reader);
+	size_t n;
+	SeqBatch *batch;
+	while (queue->get(n, batch, fetcher)) {
+		batch->records.swap(fetcher.records);
+		try {
+			for (SeqRecord &r : batch->records)
+				convert_seq(r, *value_traits, frame_mask);
+		}
+		catch (...) {
+			batch->error = std::current_exception();
+		}
+		queue->push(n);
+	}
+}
+
+}
+
+size_t load_seqs(list<TextInputFile>::iterator file_begin,
+	list<TextInputFile>::iterator file_end,
+	const Sequence_file_format &format,
+	Sequence_set** seqs,
+	String_set<char, '\0'>*& ids,
+	Sequence_set** source_seqs,
+	String_set<char, '\0'>** quals,
+	size_t max_letters,
+	const string &filter,
+	const Value_traits &value_traits,
+	size_t modulo)
+{
+	*seqs = new Sequence_set();
+	ids = new String_set<char, '\0'>();
+	if(source_seqs)
+		*source_seqs = new Sequence_set();
+	if (quals)
+		*quals = new String_set<char, '\0'>();
+
+	unsigned frame_mask = (1 << 6) - 1;
+	if (config.query_strands == "plus")
+		frame_mask = (1 << 3) - 1;
+	else if (config.query_strands == "minus")
+		frame_mask = ((1 << 3) - 1) << 3;
+
+	SeqReader reader(file_begin, file_end, format, filter, value_traits, quals != nullptr, max_letters, modulo);
+	SeqWriter writer(*seqs, ids, source_seqs ? *source_seqs : nullptr, quals ? *quals : nullptr, value_traits.seq_type);
+	SeqQueue queue(3 * config.threads_, writer);
+	vector<thread> threads;
+	for (unsigned i = 0; i < std::max(config.threads_, 1u); ++i)
+		threads.emplace_back(load_worker, &queue, &reader, &value_traits, frame_mask);
+	for (auto &t : threads)
+		t.join();
+
+	const size_t n = reader.n;
+	ids->finish_reserve();
+	if (quals)
+		(*quals)->finish_reserve();
+	(*seqs)->finish_reserve();
+	if(source_seqs)
+		(*source_seqs)->finish_reserve();
+	if (n == 0 || reader.error || writer.error) {
+		delete *seqs;
+		delete ids;
+		if(source_seqs)
+			delete *source_seqs;
+		if (quals)
+			delete *quals;
+	}
+	if (reader.error)
+		std::rethrow_exception(reader.error);
+	if (writer.error)
+		std::rethrow_exception(writer.error);
+
+	string id;
+	vector<Letter> seq;
+	list<TextInputFile>::iterator file_it = reader.file_it;
+	if (file_it != file_begin || (!reader.read_success && ++file_it != file_end && format.get_seq(id, seq, *file_it, value_traits, nullptr)))
+		throw std::runtime_error("Unequal number of sequences in paired read files.");
+	return n;
+}
@@ -16,9 +16,11 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
+#include <algorithm>
 #include "queries.h"
 #include "../util/sequence/sequence.h"
 #include "../basic/config.h"
+#include "../util/algo/MurmurHash3.h"
 
 using namespace std;
 
@@ -33,6 +35,64 @@ Seed_set *query_seeds = 0;
 Hashed_seed_set *query_seeds_hashed = 0;
 String_set<char, '\0'> *query_qual = nullptr;
 vector<unsigned> query_block_to_database_id;
+bool symmetric_self_search = false;
+unique_ptr<QueryDedup> query_dedup;
+const uint32_t QueryDedup::NONE;
+
+static sequence dedup_seq(size_t query)
+{
+	return align_mode.query_translated ? query_source_seqs::get()[query] : query_seqs::get()[query];
+}
+
+QueryDedup::QueryDedup() :
+	member_count_(0)
+{
+	const size_t n = query_ids::get().get_length();
+	vector<pair<uint64_t, uint32_t>> keys;
+	keys.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		const sequence s = dedup_seq(i);
+		uint64_t h[2] = { 0, 0 };
+		MurmurHash3_x64_128(s.data(), (int)s.length(), (const char*)h, h);
+		keys.emplace_back(h[0], (uint32_t)i);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	rep_.resize(n);
+	for (size_t i = 0; i < n; ++i)
+		rep_[i] = (uint32_t)i;
+	for (size_t begin = 0, end; begin < n; begin = end) {
+		for (end = begin + 1; end < n && keys[end].first == keys[begin].first; ++end);
+		for (size_t i = begin + 1; i < end; ++i) {
+			const uint32_t q = keys[i].second;
+			for (size_t j = begin; j < i; ++j) {
+				const uint32_t r = keys[j].second;
+				if (rep_[r] == r && dedup_seq(q) == dedup_seq(r)) {
+					rep_[q] = r;
+					++member_count_;
+					break;
+				}
+			}
+		}
+	}
+
+	const unsigned contexts = align_mode.query_contexts;
+	member_seqs_.assign(n * contexts, false);
+	for (size_t i = 0; i < n; ++i)
+		if (member(i))
+			std::fill(member_seqs_.begin() + i * contexts, member_seqs_.begin() + (i + 1) * contexts, true);
+
+	next_.assign(n, NONE);
+	multiplicity_.assign(n, 0);
+	vector<uint32_t> last(n, NONE);
+	for (size_t i = 0; i < n; ++i) {
+		const uint32_t r = rep_[i];
+		++multiplicity_[r];
+		if (r != i)
+			next_[last[r] == NONE ? r : last[r]] = (uint32_t)i;
+		last[r] = (uint32_t)i;
+	}
+}
 
 void write_unaligned(OutputFile *file)
 {
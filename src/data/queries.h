@@ -20,6 +20,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define QUERIES_H_
 
 #include <mutex>
+#include <memory>
+#include <vector>
 #include "../basic/translate.h"
 #include "../basic/statistics.h"
 #include "sequence_set.h"
@@ -74,8 +76,48 @@ inline TranslatedSequence get_translated_query(size_t query_id)
 		return TranslatedSequence(query_seqs::get()[query_id]);
 }
 
+// Groups the queries of the current block that have identical sequences.
+// Only the first query of each group (its representative) takes part in the
+// search. The seeds of the other members are not indexed, and the
+// alignments of the representative are reported for each of them.
+struct QueryDedup
+{
+	static const uint32_t NONE = UINT32_MAX;
+	QueryDedup();
+	bool member(size_t query) const
+	{
+		return rep_[query] != query;
+	}
+	// Next query of the same group in input order, or NONE.
+	uint32_t next(size_t query) const
+	{
+		return next_[query];
+	}
+	// Number of queries represented by the query (1 for queries without duplicates).
+	uint32_t multiplicity(size_t query) const
+	{
+		return multiplicity_[query];
+	}
+	size_t member_count() const
+	{
+		return member_count_;
+	}
+	// Flags the query contexts of members, which are left out of the query seed index.
+	const std::vector<bool>& member_seqs() const
+	{
+		return member_seqs_;
+	}
+private:
+	std::vector<uint32_t> rep_, next_, multiplicity_;
+	std::vector<bool> member_seqs_;
+	size_t member_count_;
+};
+
+extern std::unique_ptr<QueryDedup> query_dedup;
+
 extern Seed_set *query_seeds;
 extern Hashed_seed_set *query_seeds_hashed;
 extern vector<unsigned> query_block_to_database_id;
+extern bool symmetric_self_search;
 
 #endif /* QUERIES_H_ */
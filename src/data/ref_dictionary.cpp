@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // #include <sstream>
 // #include <iomanip>
 #include <cstdio>
+#include <string.h>
 #include <utility>
 #include "reference.h"
 #include "ref_dictionary.h"
@@ -31,14 +32,14 @@ using std::pair;
 ReferenceDictionary ReferenceDictionary::instance_;
 std::unordered_map<size_t,ReferenceDictionary> ReferenceDictionary::block_instances_;
 
-string* get_allseqids(const char *s)
+string get_allseqids(const char *s)
 {
-	string *r = new string;
+	string r;
 	const vector<string> t(tokenize(s, "\1"));
 	for (vector<string>::const_iterator i = t.begin(); i != t.end(); ++i) {
 		if (i != t.begin())
-			r->append("\1");
-		r->append(i->substr(0, find_first_of(i->c_str(), Const::id_delimiters)));
+			r.append("\1");
+		r.append(i->substr(0, find_first_of(i->c_str(), Const::id_delimiters)));
 	}
 	return r;
 }
@@ -48,7 +49,8 @@ void ReferenceDictionary::clear()
 	data_.clear();
 	len_.clear();
 	database_id_.clear();
-	name_.clear();
+	names_.clear();
+	name_pos_.clear();
 	next_ = 0;
 }
 
@@ -89,17 +91,26 @@ uint32_t ReferenceDictionary::get(unsigned block, size_t block_id)
 			database_id_.push_back((*block_to_database_id_)[block_id]);
 			const char *title = ref_ids::get()[block_id];
 			if (config.salltitles)
-				name_.push_back(new string(title));
-			else if (config.sallseqid)
-				name_.push_back(get_allseqids(title));
+				push_name(title, title + strlen(title));
+			else if (config.sallseqid || config.expand_titles) {
+				const string s = get_allseqids(title);
+				push_name(s.data(), s.data() + s.length());
+			}
 			else
-				name_.push_back(get_str(title, Const::id_delimiters));
+				push_name(title, title + find_first_of(title, Const::id_delimiters));
 		}
 		mtx_.unlock();
 	}
 	return n;
 }
 
+void ReferenceDictionary::push_name(const char *begin, const char *end)
+{
+	name_pos_.push_back(names_.size());
+	names_.insert(names_.end(), begin, end);
+	names_.push_back('\0');
+}
+
 void ReferenceDictionary::build_lazy_dict(DatabaseFile &db_file)
 {
 	BitVector filter(db_file.ref_header.sequences);
@@ -145,11 +156,8 @@ void ReferenceDictionary::save_block(size_t query, size_t block) {
 	save_scalar(os, next_);
 	save_vector(os, len_);
 	save_vector(os, database_id_);
-	size_t sz = name_.size();
-	save_scalar(os, sz);
-	for (auto i = name_.begin(); i < name_.end(); ++i) {
-		save_vector(os, **i);
-	}
+	save_vector(os, name_pos_);
+	save_vector(os, names_);
 }
 
 void ReferenceDictionary::load_block(size_t query, size_t block, ReferenceDictionary & d) {
@@ -158,13 +166,8 @@ void ReferenceDictionary::load_block(size_t query, size_t block, ReferenceDictio
 	load_scalar(is, d.next_);
 	load_vector(is, d.len_);
 	load_vector(is, d.database_id_);
-	size_t sz;
-	load_scalar(is, sz);
-	for (size_t i = 0; i < sz; ++i) {
-		string * buf = new string();
-		load_string(is, *buf);
-		d.name_.push_back(buf);
-	}
+	load_vector(is, d.name_pos_);
+	load_vector(is, d.names_);
 	is.close();
 	std::remove(i_file.c_str());
 }
@@ -178,7 +181,8 @@ void ReferenceDictionary::restore_blocks(size_t query, size_t n_blocks) {
 
 void ReferenceDictionary::clear_block(size_t block) {
 	len_.clear();
-	name_.clear();
+	names_.clear();
+	name_pos_.clear();
 	database_id_.clear();
 	data_[block].clear();
 	next_ = 0;
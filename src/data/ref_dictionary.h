@@ -25,7 +25,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <unordered_map>
 #include <mutex>
 #include <string>
-#include "../util/ptr_vector.h"
 #include "../util/io/output_file.h"
 #include "reference.h"
 
@@ -52,7 +51,7 @@ struct ReferenceDictionary
 
 	const char* name(uint32_t i) const
 	{
-		return config.no_dict ? "" : name_[i].c_str();
+		return config.no_dict ? "" : &names_[name_pos_[i]];
 	}
 
 	sequence seq(size_t i) const
@@ -117,8 +116,12 @@ private:
 	vector<vector<uint32_t>> data_;
 	// vector<vector<uint32_t>> init_data_;
 
+	void push_name(const char *begin, const char *end);
+
 	vector<uint32_t> len_, database_id_;
-	PtrVector<string> name_;
+	// Titles are stored zero-terminated in one buffer, indexed by dictionary id.
+	vector<char> names_;
+	vector<uint64_t> name_pos_;
 	//vector<uint32_t> rev_map_;
 	uint32_t next_;
 	vector<uint32_t> dict_to_lazy_dict_id_;
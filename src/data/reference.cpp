@@ -28,6 +28,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <memory>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <exception>
 #include "../basic/config.h"
 #include "reference.h"
 #include "load_seqs.h"
@@ -58,7 +61,7 @@ Serializer& operator<<(Serializer &s, const ReferenceHeader2 &h)
 	s.unset(Serializer::VARINT);
 	s << sizeof(ReferenceHeader2);
 	s.write(h.hash, sizeof(h.hash));
-	s << h.taxon_array_offset << h.taxon_array_size << h.taxon_nodes_offset << h.taxon_names_offset;
+	s << h.taxon_array_offset << h.taxon_array_size << h.taxon_nodes_offset << h.taxon_names_offset << h.mask_fingerprint;
 	return s;
 }
 
@@ -69,6 +72,7 @@ Deserializer& operator>>(Deserializer &d, ReferenceHeader2 &h)
 		>> h.taxon_array_size
 		>> h.taxon_nodes_offset
 		>> h.taxon_names_offset
+		>> h.mask_fingerprint
 		>> Finish();
 	return d;
 }
@@ -167,6 +171,11 @@ bool DatabaseFile::has_taxon_scientific_names() {
 
 }
 
+bool DatabaseFile::soft_masked() const
+{
+	return header2.mask_fingerprint != 0 && Masking::instance && header2.mask_fingerprint == Masking::get().fingerprint();
+}
+
 void DatabaseFile::rewind()
 {
 	pos_array_offset = ref_header.pos_array_offset;
@@ -189,6 +198,178 @@ void push_seq(const sequence &seq, const char *id, size_t id_len, uint64_t &offs
 	offset += seq.length() + id_len + 3;
 }
 
+struct DbChunk
+{
+	DbChunk() :
+		seqs(nullptr),
+		ids(nullptr),
+		n(0),
+		line_count(0)
+	{}
+	Sequence_set *seqs;
+	String_set<char, 0> *ids;
+	size_t n, line_count;
+	std::exception_ptr error;
+};
+
+static void load_db_chunk(list<TextInputFile> *db_file, DbChunk *chunk)
+{
+	try {
+		chunk->n = load_seqs(db_file->begin(), db_file->end(), FASTA_format(), &chunk->seqs, chunk->ids, 0, nullptr, (size_t)(1e9), string(), amino_acid_traits);
+		chunk->line_count = db_file->front().line_count;
+	}
+	catch (...) {
+		chunk->error = std::current_exception();
+	}
+}
+
+static void hash_db_chunk(const Sequence_set *seqs, const String_set<char, 0> *ids, char *hash)
+{
+	for (size_t i = 0; i < seqs->get_length(); ++i) {
+		const sequence seq = (*seqs)[i];
+		MurmurHash3_x64_128(seq.data(), (int)seq.length(), hash, hash);
+		MurmurHash3_x64_128((*ids)[i], ids->length(i), hash, hash);
+	}
+}
+
+static void get_accessions(const String_set<char, 0> *ids, vector<vector<string>> *out)
+{
+	const size_t n = ids->get_length();
+	out->clear();
+	out->resize(n);
+	atomic<size_t> next(0);
+	auto worker = [&]() {
+		size_t i;
+		while ((i = next++) < n)
+			(*out)[i] = Taxonomy::Accession::from_title((*ids)[i]);
+	};
+	vector<thread> threads;
+	for (size_t i = 0; i < std::max(config.threads_, 2u) - 1; ++i)
+		threads.emplace_back(worker);
+	for (auto &t : threads)
+		t.join();
+}
+
+// Stores each distinct sequence once for --collapse-identical. All input
+// sequences are written to a temporary file, and only their positions and
+// sequence hashes are kept in memory. When the file is copied to the
+// database, sequences with equal hashes are compared by reading them back, so
+// that hash collisions never merge different sequences. The titles of the
+// copies are appended to the first occurrence in input order.
+struct SeqCollapser
+{
+
+	SeqCollapser() :
+		n_seqs_(0),
+		letters_(0),
+		collapsed(0)
+	{}
+
+	void add(const Sequence_set &seqs, const String_set<char, 0> &ids)
+	{
+		for (size_t i = 0; i < seqs.get_length(); ++i) {
+			const sequence seq = seqs[i];
+			uint64_t h[2] = { 0, 0 };
+			MurmurHash3_x64_128(seq.data(), (int)seq.length(), (const char*)h, h);
+			hashes_.emplace_back(h[0], (uint32_t)body_pos_.size());
+			push_seq(seq, ids[i], ids.length(i), body_offset_, body_pos_, body_, letters_, n_seqs_);
+		}
+	}
+
+	// Copies the distinct sequences with their merged titles to the database.
+	void write(uint64_t &offset, vector<Pos_record> &pos_array, OutputFile &out, size_t &letters, size_t &n_seqs, char *hash, FileBackedBuffer *accessions)
+	{
+		InputFile in(body_);
+		vector<uint32_t> next;
+		vector<bool> copy;
+		link_copies(in, next, copy);
+
+		vector<Letter> seq;
+		string id, title;
+		for (uint32_t r = 0; r < body_pos_.size(); ++r) {
+			if (copy[r])
+				continue;
+			read_seq(in, r, seq);
+			in >> id;
+			for (uint32_t i = next[r]; i != NONE; i = next[i]) {
+				in.seek(body_pos_[i].pos + body_pos_[i].seq_len + 2);
+				in >> title;
+				id.append("\1").append(title);
+			}
+			push_seq(sequence(seq), id.c_str(), id.length(), offset, pos_array, out, letters, n_seqs);
+			MurmurHash3_x64_128(seq.data(), (int)seq.size(), hash, hash);
+			MurmurHash3_x64_128(id.c_str(), (int)id.length(), hash, hash);
+			if (accessions)
+				*accessions << Taxonomy::Accession::from_title(id.c_str());
+		}
+		in.close_and_delete();
+	}
+
+private:
+
+	static const uint32_t NONE = UINT32_MAX;
+
+	void read_seq(InputFile &in, uint32_t i, vector<Letter> &seq) const
+	{
+		char c;
+		seq.resize(body_pos_[i].seq_len);
+		in.seek(body_pos_[i].pos);
+		in.read(c);
+		in.read(seq.data(), seq.size());
+		in.read(c);
+	}
+
+	// Sets next[r] to the next copy of sequence r in input order and flags the
+	// copies, comparing the sequences of each group of equal hashes.
+	void link_copies(InputFile &in, vector<uint32_t> &next, vector<bool> &copy)
+	{
+		std::sort(hashes_.begin(), hashes_.end());
+		next.assign(body_pos_.size(), NONE);
+		copy.assign(body_pos_.size(), false);
+		vector<vector<Letter>> rep_seqs;
+		vector<uint32_t> tails;
+		vector<Letter> seq;
+		for (size_t begin = 0, end; begin < hashes_.size(); begin = end) {
+			for (end = begin + 1; end < hashes_.size() && hashes_[end].first == hashes_[begin].first; ++end);
+			if (end - begin == 1)
+				continue;
+			rep_seqs.clear();
+			tails.clear();
+			for (size_t j = begin; j < end; ++j) {
+				const uint32_t i = hashes_[j].second;
+				read_seq(in, i, seq);
+				size_t k = 0;
+				while (k < rep_seqs.size() && rep_seqs[k] != seq)
+					++k;
+				if (k < rep_seqs.size()) {
+					next[tails[k]] = i;
+					tails[k] = i;
+					copy[i] = true;
+					++collapsed;
+				}
+				else {
+					rep_seqs.push_back(seq);
+					tails.push_back(i);
+				}
+			}
+		}
+		vector<pair<uint64_t, uint32_t>>().swap(hashes_);
+	}
+
+	TempFile body_;
+	uint64_t body_offset_ = 0;
+	vector<Pos_record> body_pos_;
+	size_t n_seqs_, letters_;
+	vector<pair<uint64_t, uint32_t>> hashes_;
+
+public:
+
+	size_t collapsed;
+
+};
+
+const uint32_t SeqCollapser::NONE;
+
 void make_db(TempFile **tmp_out, list<TextInputFile> *input_file)
 {
 	if (config.input_ref_file.size() > 1)
@@ -212,6 +393,8 @@ void make_db(TempFile **tmp_out, list<TextInputFile> *input_file)
 	OutputFile *out = tmp_out ? new TempFile() : new OutputFile(config.database);
 	ReferenceHeader header;
 	ReferenceHeader2 header2;
+	if (config.masking == 1)
+		header2.mask_fingerprint = Masking::get().fingerprint();
 
 	*out << header;
 	*out << header2;
@@ -219,41 +402,83 @@ void make_db(TempFile **tmp_out, list<TextInputFile> *input_file)
 	size_t letters = 0, n = 0, n_seqs = 0;
 	uint64_t offset = out->tell();
 
-	Sequence_set *seqs;
-	String_set<char, 0> *ids;
-	const FASTA_format format;
 	vector<Pos_record> pos_array;
 	FileBackedBuffer accessions;
-
+	vector<vector<string>> chunk_accessions;
+	unique_ptr<SeqCollapser> collapser(config.collapse_identical ? new SeqCollapser : nullptr);
+
+	// The next chunk is parsed in the background while the current one is
+	// masked and written. Hashing and accession extraction run concurrently
+	// to writing; the output order and the database hash are unchanged.
+	DbChunk chunk, next;
+	std::thread loader;
 	try {
-		while ((timer.go("Loading sequences"), n = load_seqs(db_file->begin(), db_file->end(), format, &seqs, ids, 0, nullptr, (size_t)(1e9), string(), amino_acid_traits)) > 0) {
+		timer.go("Loading sequences");
+		load_db_chunk(db_file, &chunk);
+		while (!chunk.error && (n = chunk.n) > 0) {
+			Sequence_set *seqs = chunk.seqs;
+			String_set<char, 0> *ids = chunk.ids;
+			for (size_t i = 0; i < n; ++i)
+				if ((*seqs)[i].length() == 0)
+					throw std::runtime_error("File format error: sequence of length 0 at line " + to_string(chunk.line_count));
+			next = DbChunk();
+			loader = std::thread(load_db_chunk, db_file, &next);
+
 			if (config.masking == 1) {
 				timer.go("Masking sequences");
 				mask_seqs(*seqs, Masking::get(), false);
 			}
-			timer.go("Writing sequences");
-			for (size_t i = 0; i < n; ++i) {
-				sequence seq = (*seqs)[i];
-				if (seq.length() == 0)
-					throw std::runtime_error("File format error: sequence of length 0 at line " + to_string(db_file->front().line_count));
-				push_seq(seq, (*ids)[i], ids->length(i), offset, pos_array, *out, letters, n_seqs);
+			if (collapser) {
+				timer.go("Collapsing identical sequences");
+				collapser->add(*seqs, *ids);
+				delete seqs;
+				delete ids;
+				timer.go("Loading sequences");
+				loader.join();
+				chunk = next;
+				continue;
 			}
-			if (!config.prot_accession2taxid.empty()) {
-				timer.go("Writing accessions");
+			timer.go("Writing sequences");
+			std::thread hasher(hash_db_chunk, seqs, ids, header2.hash), acc_worker;
+			if (!config.prot_accession2taxid.empty())
+				acc_worker = std::thread(get_accessions, ids, &chunk_accessions);
+			try {
 				for (size_t i = 0; i < n; ++i)
-					accessions << Taxonomy::Accession::from_title((*ids)[i]);
+					push_seq((*seqs)[i], (*ids)[i], ids->length(i), offset, pos_array, *out, letters, n_seqs);
 			}
-			timer.go("Hashing sequences");
-			for (size_t i = 0; i < n; ++i) {
-				sequence seq = (*seqs)[i];
-				MurmurHash3_x64_128(seq.data(), (int)seq.length(), header2.hash, header2.hash);
-				MurmurHash3_x64_128((*ids)[i], ids->length(i), header2.hash, header2.hash);
+			catch (std::exception&) {
+				hasher.join();
+				if (acc_worker.joinable())
+					acc_worker.join();
+				throw;
+			}
+			hasher.join();
+			if (acc_worker.joinable()) {
+				acc_worker.join();
+				timer.go("Writing accessions");
+				for (const vector<string> &a : chunk_accessions)
+					accessions << a;
 			}
 			delete seqs;
 			delete ids;
+
+			timer.go("Loading sequences");
+			loader.join();
+			chunk = next;
+		}
+		if (chunk.error)
+			std::rethrow_exception(chunk.error);
+		if (collapser) {
+			timer.go("Writing sequences");
+			collapser->write(offset, pos_array, *out, letters, n_seqs, header2.hash, config.prot_accession2taxid.empty() ? nullptr : &accessions);
 		}
 	}
 	catch (std::exception&) {
+		if (loader.joinable()) {
+			loader.join();
+			delete next.seqs;
+			delete next.ids;
+		}
 		out->close();
 		out->remove();
 		throw;
@@ -305,6 +530,8 @@ void make_db(TempFile **tmp_out, list<TextInputFile> *input_file)
 	timer.finish();
 	message_stream << "Database hash = " << hex_print(header2.hash, 16) << endl;
 	message_stream << "Processed " << n_seqs << " sequences, " << letters << " letters." << endl;
+	if (collapser)
+		message_stream << "Collapsed " << collapser->collapsed << " identical sequences." << endl;
 	message_stream << "Total time = " << total.get() << "s" << endl;
 }
 
@@ -317,12 +544,15 @@ size_t DatabaseFile::tell_seq() const {
 }
 
 void DatabaseFile::seek_direct() {
-	seek(sizeof(ReferenceHeader) + sizeof(ReferenceHeader2) + 8);
+	seek(ref_header.pos_array_offset);
+	Pos_record r;
+	*this >> r;
+	seek(r.pos);
 }
 
-bool DatabaseFile::load_seqs(vector<uint32_t>* block2db_id, const size_t max_letters, Sequence_set **dst_seq, String_set<char, 0> **dst_id, bool load_ids, const BitVector* filter, const bool fetch_seqs, const Chunk & chunk)
+bool DatabaseFile::load_seqs(vector<uint32_t>* block2db_id, const size_t max_letters, Sequence_set **dst_seq, String_set<char, 0> **dst_id, bool load_ids, const BitVector* filter, const bool fetch_seqs, const Chunk & chunk, const bool verbose, const bool hard_mask)
 {
-	task_timer timer("Loading reference sequences");
+	task_timer timer("Loading reference sequences", verbose ? 1 : UINT_MAX);
 
 	if (max_letters > 0) {
 		seek(pos_array_offset);
@@ -404,6 +634,7 @@ bool DatabaseFile::load_seqs(vector<uint32_t>* block2db_id, const size_t max_let
 		if(load_ids) (*dst_id)->finish_reserve();
 		seek(start_offset);
 
+		size_t masked = 0;
 		for (size_t i = 0; i < filtered_seq_count; ++i) {
 			if (filter && filtered_pos[i]) seek(filtered_pos[i]);
 			/*if (filter && !filtered_seqs[i]) {
@@ -417,10 +648,16 @@ bool DatabaseFile::load_seqs(vector<uint32_t>* block2db_id, const size_t max_let
 				read((*dst_id)->ptr(i), (*dst_id)->length(i) + 1);
 			else
 				if (!seek_forward('\0')) throw std::runtime_error("Unexpected end of file.");
-			Masking::get().remove_bit_mask((*dst_seq)->ptr(i), (*dst_seq)->length(i));
+			if (hard_mask)
+				Masking::get().bit_to_hard_mask((*dst_seq)->ptr(i), (*dst_seq)->length(i), masked);
+			else
+				Masking::get().remove_bit_mask((*dst_seq)->ptr(i), (*dst_seq)->length(i));
 		}
 		timer.finish();
-		(*dst_seq)->print_stats();
+		if (hard_mask)
+			log_stream << "Masked letters: " << masked << endl;
+		if (verbose)
+			(*dst_seq)->print_stats();
 	}
 
 	if (config.multiprocessing || config.global_ranking_targets)
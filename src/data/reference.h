@@ -58,12 +58,16 @@ struct ReferenceHeader2
 		taxon_array_offset(0),
 		taxon_array_size(0),
 		taxon_nodes_offset(0),
-		taxon_names_offset(0)
+		taxon_names_offset(0),
+		mask_fingerprint(0)
 	{
 		memset(hash, 0, sizeof(hash));
 	}
 	char hash[16];
 	uint64_t taxon_array_offset, taxon_array_size, taxon_nodes_offset, taxon_names_offset;
+	// Masking::fingerprint() of the parameters used to compute the soft mask
+	// stored with the sequences, 0 if the sequences are not soft masked.
+	uint64_t mask_fingerprint;
 
 	friend Serializer& operator<<(Serializer &s, const ReferenceHeader2 &h);
 	friend Deserializer& operator>>(Deserializer &d, ReferenceHeader2 &h);
@@ -107,7 +111,9 @@ struct DatabaseFile : public InputFile
 	void clear_partition();
 	size_t get_n_partition_chunks();
 
-	bool load_seqs(std::vector<uint32_t>* block2db_id, size_t max_letters, Sequence_set **dst_seq, String_set<char, 0> **dst_id, bool load_ids = true, const BitVector* filter = nullptr, const bool fetch_seqs = true, const Chunk & chunk = Chunk());
+	// If hard_mask is set, the stored soft mask is converted into a hard mask
+	// instead of being removed. Requires soft_masked().
+	bool load_seqs(std::vector<uint32_t>* block2db_id, size_t max_letters, Sequence_set **dst_seq, String_set<char, 0> **dst_id, bool load_ids = true, const BitVector* filter = nullptr, const bool fetch_seqs = true, const Chunk & chunk = Chunk(), const bool verbose = true, const bool hard_mask = false);
 
 	void get_seq();
 	void read_seq(string &id, vector<Letter> &seq);
@@ -115,6 +121,7 @@ struct DatabaseFile : public InputFile
 	bool has_taxon_id_lists();
 	bool has_taxon_nodes();
 	bool has_taxon_scientific_names();
+	bool soft_masked() const;
 	void close();
 	void seek_seq(size_t i);
 	size_t tell_seq() const;
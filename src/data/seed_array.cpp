@@ -21,14 +21,37 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "seed_set.h"
 #include "enum_seeds.h"
 #include "../util/data_structures/deque.h"
+#include "../util/system/numa.h"
+#include "../util/memory/huge_pages.h"
 
 using std::array;
 
 typedef vector<Array<SeedArray::Entry*, Const::seedp>> PtrSet;
 
+// With --numa, the pages of the buffer are placed on the nodes that process
+// the seed partitions stored in them. The buffer is reused for all shapes and
+// lowmem chunks, so the placement follows the partition layout of the first
+// seed array built in it (shape 0, first chunk). Partition sizes of the other
+// shapes are similar but not equal. The hash join results are written to the
+// same buffer, so they share its huge page backing (--huge-pages).
 char* SeedArray::alloc_buffer(const Partitioned_histogram &hst)
 {
-	return new char[sizeof(Entry) * hst.max_chunk_size()];
+	const size_t size = sizeof(Entry) * hst.max_chunk_size();
+	char *buffer = (char*)Util::Memory::huge_page_alloc(size);
+	if (Numa::active()) {
+		const ::partition<unsigned> p(Const::seedp, config.lowmem);
+		vector<size_t> offsets(1, 0);
+		for (unsigned i = p.getMin(0); i < p.getMax(0); ++i)
+			offsets.push_back(offsets.back() + sizeof(Entry) * partition_size(hst.get(0), i));
+		offsets.back() = size;
+		Numa::first_touch(buffer, offsets, config.threads_);
+	}
+	return buffer;
+}
+
+void SeedArray::free_buffer(char *buffer)
+{
+	Util::Memory::huge_page_free(buffer);
 }
 
 struct BufferedWriter
@@ -101,7 +124,7 @@ struct BuildCallback
 };
 
 template<typename _filter>
-SeedArray::SeedArray(const Sequence_set &seqs, size_t shape, const shape_histogram &hst, const SeedPartitionRange &range, const vector<size_t> &seq_partition, char *buffer, const _filter *filter) :
+SeedArray::SeedArray(const Sequence_set &seqs, size_t shape, const shape_histogram &hst, const SeedPartitionRange &range, const vector<size_t> &seq_partition, char *buffer, const _filter *filter, const vector<bool> *skip) :
 	data_((Entry*)buffer)
 {
 	begin_[range.begin()] = 0;
@@ -112,12 +135,21 @@ SeedArray::SeedArray(const Sequence_set &seqs, size_t shape, const shape_histogr
 	PtrVector<BuildCallback> cb;
 	for (size_t i = 0; i < seq_partition.size() - 1; ++i)
 		cb.push_back(new BuildCallback(range, iterators[i].begin()));
-	enum_seeds(&seqs, cb, seq_partition, shape, shape + 1, filter);
+	enum_seeds(&seqs, cb, seq_partition, shape, shape + 1, filter, false, skip);
 }
 
-template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const No_filter *);
-template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const Seed_set *);
-template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const Hashed_seed_set *);
+template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const No_filter *, const vector<bool> *);
+template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const Seed_set *, const vector<bool> *);
+template SeedArray::SeedArray(const Sequence_set &, size_t, const shape_histogram &, const SeedPartitionRange &, const vector<size_t>&, char *buffer, const Hashed_seed_set *, const vector<bool> *);
+
+SeedArray::SeedArray(Entry* data, const SeedPartitionRange& range, const uint64_t* begin) :
+	data_(data)
+{
+	std::fill(begin_, begin_ + range.begin(), 0);
+	for (size_t i = range.begin(); i <= range.end(); ++i)
+		begin_[i] = begin[i - range.begin()];
+	std::fill(begin_ + range.end() + 1, begin_ + Const::seedp + 1, begin_[range.end()]);
+}
 
 struct BufferedWriter2
 {
@@ -176,14 +208,14 @@ struct BuildCallback2
 };
 
 template<typename _filter>
-SeedArray::SeedArray(const Sequence_set& seqs, size_t shape, const SeedPartitionRange& range, const _filter* filter) :
+SeedArray::SeedArray(const Sequence_set& seqs, size_t shape, const SeedPartitionRange& range, const _filter* filter, const vector<bool> *skip) :
 	data_(nullptr)
 {
 	const auto seq_partition = seqs.partition(config.threads_);
 	PtrVector<BuildCallback2> cb;
 	for (size_t i = 0; i < seq_partition.size() - 1; ++i)
 		cb.push_back(new BuildCallback2(range));
-	enum_seeds(&seqs, cb, seq_partition, shape, shape + 1, filter);
+	enum_seeds(&seqs, cb, seq_partition, shape, shape + 1, filter, false, skip);
 
 	array<size_t, Const::seedp> counts;
 	counts.fill(0);
@@ -198,4 +230,4 @@ SeedArray::SeedArray(const Sequence_set& seqs, size_t shape, const SeedPartition
 	}
 }
 
-template SeedArray::SeedArray(const Sequence_set&, size_t, const SeedPartitionRange&, const Hashed_seed_set*);
\ No newline at end of file
+template SeedArray::SeedArray(const Sequence_set&, size_t, const SeedPartitionRange&, const Hashed_seed_set*, const vector<bool>*);
\ No newline at end of file
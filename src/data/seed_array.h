@@ -50,11 +50,14 @@ struct SeedArray
 		typedef uint32_t Key;
 	} PACKED_ATTRIBUTE;
 
+	// Sequences i with (*skip)[i] set are not indexed.
 	template<typename _filter>
-	SeedArray(const Sequence_set &seqs, size_t shape, const shape_histogram &hst, const SeedPartitionRange &range, const vector<size_t> &seq_partition, char *buffer, const _filter *filter);
+	SeedArray(const Sequence_set &seqs, size_t shape, const shape_histogram &hst, const SeedPartitionRange &range, const vector<size_t> &seq_partition, char *buffer, const _filter *filter, const std::vector<bool> *skip = nullptr);
 
 	template<typename _filter>
-	SeedArray(const Sequence_set& seqs, size_t shape, const SeedPartitionRange& range, const _filter* filter);
+	SeedArray(const Sequence_set& seqs, size_t shape, const SeedPartitionRange& range, const _filter* filter, const std::vector<bool> *skip = nullptr);
+
+	SeedArray(Entry* data, const SeedPartitionRange& range, const uint64_t* begin);
 
 	Entry* begin(unsigned i)
 	{
@@ -93,6 +96,7 @@ struct SeedArray
 	}
 
 	static char *alloc_buffer(const Partitioned_histogram &hst);
+	static void free_buffer(char *buffer);
 
 private:
 
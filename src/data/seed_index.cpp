@@ -0,0 +1,305 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <string.h>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include "seed_index.h"
+#include "reference.h"
+#include "queries.h"
+#include "../basic/config.h"
+#include "../basic/masking.h"
+#include "../basic/shape_config.h"
+#include "../basic/reduction.h"
+#include "../search/search.h"
+#include "../util/io/output_file.h"
+#include "../util/io/deserializer.h"
+#include "../util/system/system.h"
+#include "../util/log_stream.h"
+#include "../util/util.h"
+
+using std::string;
+using std::vector;
+using std::endl;
+
+enum { MASKING = 1, HASHED_SEEDS = 2 };
+
+// Records are memory mapped and accessed as uint64_t and Entry arrays, so each
+// one starts on a cache line.
+static const size_t ALIGNMENT = 64;
+
+static size_t aligned(size_t n)
+{
+	return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+static void write_padding(OutputFile &out)
+{
+	static const char zero[ALIGNMENT] = { 0 };
+	const size_t n = out.tell();
+	out.write(zero, aligned(n) - n);
+}
+
+static uint32_t index_flags()
+{
+	uint32_t flags = 0;
+	if (config.masking == 1 && !config.no_ref_masking)
+		flags |= MASKING;
+	if (config.hashed_seeds)
+		flags |= HASHED_SEEDS;
+	return flags;
+}
+
+static string shapes_string()
+{
+	std::ostringstream ss;
+	ss << ::shapes;
+	return ss.str();
+}
+
+static string reduction_string()
+{
+	std::ostringstream ss;
+	ss << Reduction::reduction;
+	return ss.str();
+}
+
+SeedIndex::Header::Header() :
+	magic_number(MAGIC_NUMBER),
+	version(CURRENT_VERSION),
+	block_size(0),
+	index_chunks(0),
+	flags(0),
+	entry_size(sizeof(SeedArray::Entry)),
+	shape_count(0),
+	blocks(0),
+	table_offset(0)
+{
+	memset(db_hash, 0, sizeof(db_hash));
+}
+
+static Serializer& operator<<(Serializer& s, const SeedIndex::Header& h)
+{
+	s.unset(Serializer::VARINT);
+	s << h.magic_number << h.version;
+	s.write(h.db_hash, sizeof(h.db_hash));
+	s << h.block_size << h.index_chunks << h.flags << h.entry_size << h.shape_count << h.shapes << h.reduction << h.blocks << h.table_offset;
+	return s;
+}
+
+static Deserializer& operator>>(Deserializer& d, SeedIndex::Header& h)
+{
+	d.varint = false;
+	d >> h.magic_number;
+	if (h.magic_number != SeedIndex::Header::MAGIC_NUMBER)
+		throw std::runtime_error("Seed index file has an invalid format.");
+	d >> h.version;
+	if (h.version != SeedIndex::Header::CURRENT_VERSION)
+		throw std::runtime_error("Seed index file was built with an incompatible version of Diamond.");
+	if (d.read(h.db_hash, sizeof(h.db_hash)) != sizeof(h.db_hash))
+		throw EndOfStream();
+	d >> h.block_size >> h.index_chunks >> h.flags >> h.entry_size >> h.shape_count >> h.shapes >> h.reduction >> h.blocks >> h.table_offset;
+	return d;
+}
+
+string SeedIndex::file_name(const string &database)
+{
+	return database + ".seedidx";
+}
+
+SeedIndex::SeedIndex(const DatabaseFile &db):
+	SeedIndex(db, file_name(config.database))
+{}
+
+SeedIndex::SeedIndex(const DatabaseFile &db, const string &f)
+{
+	auto m = mmap_file(f.c_str(), true);
+	if (std::get<0>(m) == nullptr)
+		throw std::runtime_error("Seed index file not found: " + f + ". Use the makeidx command to build it.");
+	data_ = std::get<0>(m);
+	size_ = std::get<1>(m);
+	fd_ = std::get<2>(m);
+
+	try {
+		Deserializer d(data_, data_ + size_);
+		d >> header_;
+		if (memcmp(header_.db_hash, db.header2.hash, sizeof(header_.db_hash)) != 0)
+			throw std::runtime_error("Seed index file does not match the database (hash mismatch).");
+		if (header_.entry_size != sizeof(SeedArray::Entry))
+			throw std::runtime_error("Seed index file was built with an incompatible version of Diamond.");
+		const size_t n = header_.blocks * header_.shape_count * header_.index_chunks;
+		if (header_.table_offset + n * sizeof(uint64_t) > size_)
+			throw EndOfStream();
+		offsets_.resize(n);
+		memcpy(offsets_.data(), data_ + header_.table_offset, n * sizeof(uint64_t));
+		for (uint64_t offset : offsets_)
+			if (offset % ALIGNMENT != 0 || offset >= header_.table_offset)
+				throw EndOfStream();
+	}
+	catch (EndOfStream&) {
+		unmap_file(data_, size_, fd_);
+		throw std::runtime_error("Seed index file is incomplete or corrupted.");
+	}
+	catch (std::exception&) {
+		unmap_file(data_, size_, fd_);
+		throw;
+	}
+	log_stream << "Seed index: blocks=" << header_.blocks << " shapes=" << header_.shape_count << " chunks=" << header_.index_chunks << " size=" << size_ << endl;
+}
+
+SeedIndex::~SeedIndex()
+{
+	unmap_file(data_, size_, fd_);
+}
+
+bool SeedIndex::compatible() const
+{
+	return config.algo == Config::double_indexed
+		&& query_seeds_hashed == nullptr
+		&& !config.target_indexed
+		&& header_.block_size == (uint64_t)(config.chunk_size * 1e9)
+		&& header_.index_chunks == config.lowmem
+		&& header_.flags == index_flags()
+		&& header_.shape_count == shapes.count()
+		&& header_.shapes == shapes_string()
+		&& header_.reduction == reduction_string();
+}
+
+const char* SeedIndex::record(size_t block, size_t shape, size_t chunk) const
+{
+	if (block >= header_.blocks)
+		throw std::runtime_error("Seed index file does not match the database (block count).");
+	return data_ + offsets_[(block * header_.shape_count + shape) * header_.index_chunks + chunk];
+}
+
+SeedArray* SeedIndex::get(size_t block, size_t shape, size_t chunk) const
+{
+	const ::partition<unsigned> p(Const::seedp, header_.index_chunks);
+	const SeedPartitionRange range(p.getMin((unsigned)chunk), p.getMax((unsigned)chunk));
+	const uint64_t* begin = (const uint64_t*)record(block, shape, chunk);
+	return new SeedArray((SeedArray::Entry*)(begin + range.size() + 1), range, begin);
+}
+
+void SeedIndex::release(size_t block, size_t shape, size_t chunk) const
+{
+	const ::partition<unsigned> p(Const::seedp, header_.index_chunks);
+	const SeedPartitionRange range(p.getMin((unsigned)chunk), p.getMax((unsigned)chunk));
+	const char* ptr = record(block, shape, chunk);
+	const uint64_t n = ((const uint64_t*)ptr)[range.size()];
+	discard_mapped_pages((char*)ptr, (range.size() + 1) * sizeof(uint64_t) + n * sizeof(SeedArray::Entry));
+}
+
+void make_seed_index()
+{
+	task_timer total;
+	task_timer timer("Opening the database", true);
+	DatabaseFile db(config.database);
+	timer.finish();
+
+	const string file_name = SeedIndex::file_name(config.database);
+	message_stream << "Seed index file: " << file_name << endl;
+	OutputFile out(file_name);
+	make_seed_index(db, out);
+	message_stream << "Total time = " << total.get() << "s" << endl;
+}
+
+void make_seed_index(DatabaseFile &db, OutputFile &out)
+{
+	task_timer timer;
+	align_mode = Align_mode(Align_mode::blastp);
+	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
+		Config::set_option(config.chunk_size, 0.4);
+	else
+		Config::set_option(config.chunk_size, 2.0);
+	config.algo = Config::double_indexed;
+	setup_search();
+
+	SeedIndex::Header header;
+	memcpy(header.db_hash, db.header2.hash, sizeof(header.db_hash));
+	header.block_size = (uint64_t)(config.chunk_size * 1e9);
+	header.index_chunks = config.lowmem;
+	header.flags = index_flags();
+	header.shape_count = shapes.count();
+	header.shapes = shapes_string();
+	header.reduction = reduction_string();
+
+	message_stream << "Block size = " << header.block_size << endl;
+	out << header;
+	write_padding(out);
+
+	const ::partition<unsigned> p(Const::seedp, config.lowmem);
+	vector<uint64_t> offsets;
+	Sequence_set* seqs;
+	String_set<char, 0>* ids;
+	const bool mask_on_load = (header.flags & MASKING) && db.soft_masked();
+	try {
+		while (db.load_seqs(nullptr, (size_t)header.block_size, &seqs, &ids, false, nullptr, true, Chunk(), true, mask_on_load)) {
+			if ((header.flags & MASKING) && !mask_on_load) {
+				timer.go("Masking reference");
+				mask_seqs(*seqs, Masking::get());
+			}
+			timer.go("Building reference histograms");
+			const Partitioned_histogram hst(*seqs, false, &no_filter);
+			timer.go("Allocating buffers");
+			char* buffer = SeedArray::alloc_buffer(hst);
+			for (unsigned shape = 0; shape < shapes.count(); ++shape)
+				for (unsigned chunk = 0; chunk < p.parts; ++chunk) {
+					message_stream << "Indexing reference block " << header.blocks + 1 << ", shape " << shape + 1 << "/" << shapes.count();
+					if (config.lowmem > 1)
+						message_stream << ", index chunk " << chunk + 1 << "/" << config.lowmem;
+					message_stream << '.' << endl;
+					const SeedPartitionRange range(p.getMin(chunk), p.getMax(chunk));
+					timer.go("Building reference seed array");
+					SeedArray sa(*seqs, shape, hst.get(shape), range, hst.partition(), buffer, &no_filter);
+					timer.go("Writing reference seed array");
+					write_padding(out);
+					offsets.push_back(out.tell());
+					uint64_t n = 0;
+					out.write(n);
+					for (unsigned i = range.begin(); i < range.end(); ++i) {
+						n += sa.size(i);
+						out.write(n);
+					}
+					out.write(sa.begin(range.begin()), n);
+				}
+			timer.go("Deallocating buffers");
+			SeedArray::free_buffer(buffer);
+			delete seqs;
+			++header.blocks;
+		}
+
+		timer.go("Writing trailer");
+		write_padding(out);
+		header.table_offset = out.tell();
+		out.write(offsets.data(), offsets.size());
+		out.seek(0);
+		out << header;
+		out.close();
+	}
+	catch (std::exception&) {
+		out.close();
+		out.remove();
+		throw;
+	}
+	timer.finish();
+
+	message_stream << "Indexed " << header.blocks << " reference blocks." << endl;
+}
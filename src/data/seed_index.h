@@ -0,0 +1,71 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "seed_array.h"
+
+struct DatabaseFile;
+struct OutputFile;
+
+// Prebuilt reference seed arrays for each block, shape and index chunk,
+// stored next to the database file and memory mapped at search time.
+struct SeedIndex
+{
+
+	struct Header
+	{
+		Header();
+		uint64_t magic_number;
+		uint32_t version;
+		char db_hash[16];
+		uint64_t block_size;
+		uint32_t index_chunks, flags, entry_size, shape_count;
+		std::string shapes, reduction;
+		uint64_t blocks, table_offset;
+		enum { CURRENT_VERSION = 1 };
+		static constexpr uint64_t MAGIC_NUMBER = 0x3c8a6a93a3e4d1b5llu;
+	};
+
+	SeedIndex(const DatabaseFile &db);
+	SeedIndex(const DatabaseFile &db, const std::string &file_name);
+	~SeedIndex();
+	bool compatible() const;
+	SeedArray* get(size_t block, size_t shape, size_t chunk) const;
+	void release(size_t block, size_t shape, size_t chunk) const;
+
+	static std::string file_name(const std::string &database);
+
+private:
+
+	const char* record(size_t block, size_t shape, size_t chunk) const;
+
+	Header header_;
+	char *data_;
+	size_t size_;
+	int fd_;
+	std::vector<uint64_t> offsets_;
+
+};
+
+void make_seed_index();
+void make_seed_index(DatabaseFile &db, OutputFile &out);
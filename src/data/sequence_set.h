@@ -33,6 +33,10 @@ struct Sequence_set : public String_set<Letter, sequence::DELIMITER, 1>
 
 	Sequence_set()
 	{ }
+
+	Sequence_set(Letter *data, const size_t *limits, size_t count, std::shared_ptr<void> storage):
+		String_set(data, limits, count, storage)
+	{ }
 	
 	void print_stats() const
 	{
@@ -23,8 +23,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 #include <assert.h>
 #include <vector>
+#include <memory>
 #include <stddef.h>
 #include "../basic/sequence.h"
+#include "../util/memory/huge_pages.h"
 
 template<typename _t, char _pchar = '\xff', size_t _padding = 1lu>
 struct String_set
@@ -35,7 +37,42 @@ struct String_set
 
 	String_set():
 		data_ (PERIMETER_PADDING)
-	{ limits_.push_back(PERIMETER_PADDING); }
+	{
+		limits_.push_back(PERIMETER_PADDING);
+		sync();
+	}
+
+	// Refers to a finished set stored in memory that is kept alive by storage,
+	// e.g. a memory mapped file.
+	String_set(_t *data, const size_t *limits, size_t count, std::shared_ptr<void> storage):
+		base_(data),
+		limits_ptr_(limits),
+		limit_count_(count + 1),
+		storage_(storage)
+	{}
+
+	String_set(const String_set &s):
+		data_(s.storage_ ? Data(s.base_, s.base_ + s.raw_len() + PERIMETER_PADDING) : s.data_),
+		limits_(s.limits_ptr_, s.limits_ptr_ + s.limit_count_)
+	{
+		sync();
+	}
+
+	String_set(String_set &&s) = default;
+
+	String_set& operator=(String_set &&s) = default;
+
+	String_set& operator=(const String_set &s)
+	{
+		if (this != &s) {
+			String_set tmp(s);
+			data_.swap(tmp.data_);
+			limits_.swap(tmp.limits_);
+			storage_.reset();
+			sync();
+		}
+		return *this;
+	}
 
 	void finish_reserve()
 	{
@@ -44,11 +81,13 @@ struct String_set
 			data_[i] = _pchar;
 			data_[raw_len()+i] = _pchar;
 		}
+		sync();
 	}
 
 	void reserve(size_t n)
 	{
 		limits_.push_back(raw_len() + n + _padding);
+		sync();
 	}
 
 	template<typename _it>
@@ -58,6 +97,7 @@ struct String_set
 		limits_.push_back(raw_len() + (end - begin) + _padding);
 		data_.insert(data_.end(), begin, end);
 		data_.insert(data_.end(), _padding, _pchar);
+		sync();
 	}
 
 	void fill(size_t n, _t v)
@@ -65,49 +105,50 @@ struct String_set
 		limits_.push_back(raw_len() + n + _padding);
 		data_.insert(data_.end(), n, v);
 		data_.insert(data_.end(), _padding, _pchar);
+		sync();
 	}
 
 	_t* ptr(size_t i)
-	{ return &data_[limits_[i]]; }
+	{ return &base_[limits_ptr_[i]]; }
 
 	const _t* ptr(size_t i) const
-	{ return &data_[limits_[i]]; }
+	{ return &base_[limits_ptr_[i]]; }
 
 	size_t check_idx(size_t i) const
 	{
-		if (limits_.size() < i + 2)
+		if (limit_count_ < i + 2)
 			throw std::runtime_error("Sequence set index out of bounds.");
 		return i;
 	}
 
 	size_t length(size_t i) const
-	{ return limits_[i+1] - limits_[i] - _padding; }
+	{ return limits_ptr_[i+1] - limits_ptr_[i] - _padding; }
 
 	size_t get_length() const
-	{ return limits_.size() - 1; }
+	{ return limit_count_ - 1; }
 
 	size_t raw_len() const
-	{ return limits_.back(); }
+	{ return limits_ptr_[limit_count_ - 1]; }
 
 	size_t letters() const
 	{ return raw_len() - get_length() - PERIMETER_PADDING; }
 
 	_t* data(uint64_t p = 0)
-	{ return &data_[p]; }
+	{ return &base_[p]; }
 
 	const _t* data(uint64_t p = 0) const
-	{ return &data_[p]; }
+	{ return &base_[p]; }
 
 	size_t position(const _t* p) const
 	{ return p - data(); }
 
 	size_t position(size_t i, size_t j) const
-	{ return limits_[i] + j; }
+	{ return limits_ptr_[i] + j; }
 
 	std::pair<size_t, size_t> local_position(size_t p) const
 	{
-		size_t i = std::upper_bound(limits_.begin(), limits_.end(), p) - limits_.begin() - 1;
-		return std::pair<size_t, size_t>(i, p - limits_[i]);
+		size_t i = std::upper_bound(limits_begin(), limits_end(), p) - limits_begin() - 1;
+		return std::pair<size_t, size_t>(i, p - limits_ptr_[i]);
 	}
 
 	const _t* operator[](size_t i) const
@@ -115,17 +156,30 @@ struct String_set
 		return ptr(i);
 	}
 
-	typename std::vector<size_t>::const_iterator limits_begin() const {
-		return limits_.begin();
+	const size_t* limits_begin() const {
+		return limits_ptr_;
 	}
 
-	typename std::vector<size_t>::const_iterator limits_end() const {
-		return limits_.end();
+	const size_t* limits_end() const {
+		return limits_ptr_ + limit_count_;
 	}
 
 private:
 
-	std::vector<_t> data_;
+	void sync()
+	{
+		base_ = data_.data();
+		limits_ptr_ = limits_.data();
+		limit_count_ = limits_.size();
+	}
+
+	typedef std::vector<_t, Util::Memory::HugePageAllocator<_t>> Data;
+
+	Data data_;
 	std::vector<size_t> limits_;
+	_t *base_;
+	const size_t *limits_ptr_;
+	size_t limit_count_;
+	std::shared_ptr<void> storage_;
 
 };
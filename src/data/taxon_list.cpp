@@ -17,12 +17,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
 #include <set>
+#include <thread>
+#include <atomic>
 #include "taxon_list.h"
 #include "taxonomy.h"
+#include "../basic/config.h"
 #include "../util/log_stream.h"
 
 using std::set;
 using std::endl;
+using std::thread;
+using std::atomic;
+using std::string;
 
 TaxonList::TaxonList(Deserializer &in, size_t size, size_t data_size):
 	CompactArray<vector<uint32_t>>(in, size, data_size)
@@ -30,27 +36,48 @@ TaxonList::TaxonList(Deserializer &in, size_t size, size_t data_size):
 
 void TaxonList::build(OutputFile &db, FileBackedBuffer &accessions, size_t seqs)
 {
+	static const size_t BATCH_SIZE = 1 << 20;
 	task_timer timer("Writing taxon id lists");
-	vector<string> a;
+	vector<vector<string>> a;
+	vector<set<unsigned>> t;
 	db.set(Serializer::VARINT);
-	set<unsigned> t;
-	size_t mapped = 0, mappings = 0, len_errors = 0;
-	for (size_t i = 0; i < seqs; ++i) {
-		accessions >> a;
-		for (vector<string>::const_iterator j = a.begin(); j < a.end(); ++j) {
-			try {
-				t.insert(taxonomy.get(Taxonomy::Accession(j->c_str())));
-			}
-			catch (AccessionLengthError &) {
-				++len_errors;
+	size_t mapped = 0, mappings = 0;
+	atomic<size_t> len_errors(0);
+	for (size_t begin = 0; begin < seqs; begin += BATCH_SIZE) {
+		const size_t n = std::min(seqs - begin, BATCH_SIZE);
+		a.resize(n);
+		t.clear();
+		t.resize(n);
+		for (size_t i = 0; i < n; ++i)
+			accessions >> a[i];
+
+		atomic<size_t> next(0);
+		auto worker = [&]() {
+			size_t i;
+			while ((i = next++) < n) {
+				for (vector<string>::const_iterator j = a[i].begin(); j < a[i].end(); ++j) {
+					try {
+						t[i].insert(taxonomy.get(Taxonomy::Accession(j->c_str())));
+					}
+					catch (AccessionLengthError &) {
+						++len_errors;
+					}
+				}
+				t[i].erase(0);
 			}
+		};
+		vector<thread> threads;
+		for (size_t i = 0; i < config.threads_; ++i)
+			threads.emplace_back(worker);
+		for (auto &th : threads)
+			th.join();
+
+		for (size_t i = 0; i < n; ++i) {
+			db << t[i];
+			mappings += t[i].size();
+			if (!t[i].empty())
+				++mapped;
 		}
-		t.erase(0);
-		db << t;
-		mappings += t.size();
-		if (!t.empty())
-			++mapped;
-		t.clear();
 	}
 	timer.finish();
 	message_stream << mapped << " sequences mapped to taxonomy, " << mappings << " total mappings." << endl;
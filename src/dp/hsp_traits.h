@@ -3,6 +3,7 @@
 
 #include <limits.h>
 #include <algorithm>
+#include <list>
 #include "../util/interval.h"
 #include "../basic/diagonal_segment.h"
 #include "../basic/match.h"
@@ -79,4 +80,6 @@ struct Hsp_traits
 	interval query_source_range, query_range, subject_range;
 };
 
+typedef std::list<Hsp_traits, Util::Memory::ArenaAllocator<Hsp_traits>> HspTraitsList;
+
 #endif
\ No newline at end of file
@@ -386,7 +386,7 @@ Hsp traceback(sequence *query, Strand strand, int dna_len, const Banded3FrameSwi
 }
 
 template<typename _sv, typename _traceback>
-list<Hsp> banded_3frame_swipe(
+HspList banded_3frame_swipe(
 	const TranslatedSequence &query,
 	Strand strand, vector<DpTarget>::const_iterator subject_begin,
 	vector<DpTarget>::const_iterator subject_end,
@@ -488,7 +488,7 @@ list<Hsp> banded_3frame_swipe(
 		++j;
 	}
 	
-	list<Hsp> out;
+	HspList out;
 	for (int i = 0; i < targets.n_targets; ++i) {
 		if (best[i] < ScoreTraits<_sv>::max_score()) {
 			const int score = ScoreTraits<_sv>::int_score(best[i]) * config.cbs_matrix_scale;
@@ -503,7 +503,7 @@ list<Hsp> banded_3frame_swipe(
 }
 
 template<typename _sv>
-list<Hsp> banded_3frame_swipe_targets(vector<DpTarget>::const_iterator begin,
+HspList banded_3frame_swipe_targets(vector<DpTarget>::const_iterator begin,
 	vector<DpTarget>::const_iterator end,
 	bool score_only,
 	const TranslatedSequence &query,
@@ -512,7 +512,7 @@ list<Hsp> banded_3frame_swipe_targets(vector<DpTarget>::const_iterator begin,
 	bool parallel,
 	vector<DpTarget> &overflow)
 {
-	list<Hsp> out;
+	HspList out;
 	for (vector<DpTarget>::const_iterator i = begin; i < end; i += ScoreTraits<_sv>::CHANNELS) {
 		if (score_only || config.traceback_mode == TracebackMode::SCORE_ONLY)
 			out.splice(out.end(), banded_3frame_swipe<_sv, DP::ScoreOnly>(query, strand, i, i + std::min(vector<DpTarget>::const_iterator::difference_type(ScoreTraits<_sv>::CHANNELS), end - i), stat, parallel, overflow));
@@ -528,7 +528,7 @@ void banded_3frame_swipe_worker(vector<DpTarget>::const_iterator begin,
 	bool score_only,
 	const TranslatedSequence *query,
 	Strand strand,
-	list<Hsp> *out,
+	HspList *out,
 	vector<DpTarget> *overflow)
 {
 	DpStat stat;
@@ -546,21 +546,21 @@ void banded_3frame_swipe_worker(vector<DpTarget>::const_iterator begin,
 	*overflow = std::move(of);
 }
 
-list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, vector<DpTarget>::iterator target_begin, vector<DpTarget>::iterator target_end, DpStat &stat, bool score_only, bool parallel)
+HspList banded_3frame_swipe(const TranslatedSequence &query, Strand strand, vector<DpTarget>::iterator target_begin, vector<DpTarget>::iterator target_end, DpStat &stat, bool score_only, bool parallel)
 {
 	vector<DpTarget> overflow16, overflow32;
 #ifdef __SSE2__
 	task_timer timer("Banded 3frame swipe (sort)", parallel ? 3 : UINT_MAX);
 	std::stable_sort(target_begin, target_end);
-	list<Hsp> out;
+	HspList out;
 	if (parallel) {
 		timer.go("Banded 3frame swipe (run)");
 		vector<thread> threads;
-		vector<list<Hsp>*> thread_out;
+		vector<HspList*> thread_out;
 		vector<vector<DpTarget>> thread_overflow(config.threads_);
 		atomic<size_t> next(0);
 		for (size_t i = 0; i < config.threads_; ++i) {
-			thread_out.push_back(new list<Hsp>);
+			thread_out.push_back(new HspList);
 			threads.emplace_back(banded_3frame_swipe_worker,
 				target_begin,
 				target_end,
@@ -574,7 +574,7 @@ list<Hsp> banded_3frame_swipe(const TranslatedSequence &query, Strand strand, ve
 		for (auto &t : threads)
 			t.join();
 		timer.go("Banded 3frame swipe (merge)");
-		for (list<Hsp>* l : thread_out) {
+		for (HspList* l : thread_out) {
 			out.splice(out.end(), *l);
 			delete l;
 		}
@@ -123,7 +123,7 @@ namespace DP {
 
 template<typename _sv, typename _cbs>
 struct CBSBuffer {
-	CBSBuffer(const DP::NoCBS&, int, uint32_t) {}
+	CBSBuffer(const DP::NoCBS&, int, uint64_t) {}
 	void* operator()(int i) const {
 		return nullptr;
 	}
@@ -131,7 +131,7 @@ struct CBSBuffer {
 
 template<typename _sv>
 struct CBSBuffer<_sv, const int8_t*> {
-	CBSBuffer(const int8_t* v, int l, uint32_t channel_mask) {
+	CBSBuffer(const int8_t* v, int l, uint64_t channel_mask) {
 		typedef typename ::DISPATCH_ARCH::ScoreTraits<_sv>::Score Score;
 		data.reserve(l);
 		for (int i = 0; i < l; ++i)
@@ -140,7 +140,7 @@ struct CBSBuffer<_sv, const int8_t*> {
 	_sv operator()(int i) const {
 		return data[i];
 	}
-	std::vector<_sv, Util::Memory::AlignmentAllocator<_sv, 32>> data;
+	std::vector<_sv, Util::Memory::AlignmentAllocator<_sv, 64>> data;
 };
 
 
@@ -279,7 +279,16 @@ struct SwipeProfile
 	}
 
 	void set(const int8_t** target_scores) {
-#if ARCH_ID == 2
+#if ARCH_ID == 3
+		alignas(32) int8_t t[32 * 32];
+		for (size_t c = 0; c < ScoreTraits<_sv>::CHANNELS; c += 32) {
+			transpose(target_scores + c, 32, t, __m256i());
+			for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
+				_mm256_storeu_si256((__m256i*)((int8_t*)&data_[i] + c), _mm256_load_si256((const __m256i*)(t + i * 32)));
+		}
+		for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
+			data_[i].expand_from_8bit();
+#elif ARCH_ID == 2
 		transpose(target_scores, 32, (int8_t*)data_, __m256i());
 		for (size_t i = 0; i < AMINO_ACID_COUNT; ++i)
 			data_[i].expand_from_8bit();
@@ -37,14 +37,14 @@ using std::thread;
 namespace DP { namespace Swipe { namespace DISPATCH_ARCH {
 
 template<typename _sv, typename _traceback, typename _cbs>
-list<Hsp> swipe(const sequence& query, Frame frame, DynamicIterator<DpTarget>& targets, _cbs composition_bias, vector<DpTarget>& overflow, Statistics& stats);
+HspList swipe(const sequence& query, Frame frame, DynamicIterator<DpTarget>& targets, _cbs composition_bias, vector<DpTarget>& overflow, Statistics& stats);
 
 }}}
 
 namespace DP { namespace BandedSwipe { namespace DISPATCH_ARCH {
 
 template<typename _sv, typename _traceback, typename _cbs>
-list<Hsp> swipe(
+HspList swipe(
 	const sequence &query,
 	Frame frame,
 	vector<DpTarget>::const_iterator subject_begin,
@@ -54,7 +54,7 @@ list<Hsp> swipe(
 	Statistics &stat);
 
 template<typename _sv, typename _traceback>
-list<Hsp> swipe_dispatch_cbs(
+HspList swipe_dispatch_cbs(
 	const sequence &query,
 	Frame frame,
 	vector<DpTarget>::const_iterator subject_begin,
@@ -70,7 +70,7 @@ list<Hsp> swipe_dispatch_cbs(
 }
 
 template<typename _sv, typename _traceback>
-list<Hsp> full_swipe_dispatch_cbs(
+HspList full_swipe_dispatch_cbs(
 	const sequence &query,
 	Frame frame,
 	DynamicIterator<DpTarget>& targets,
@@ -85,7 +85,7 @@ list<Hsp> full_swipe_dispatch_cbs(
 }
 
 template<typename _sv>
-list<Hsp> swipe_targets(const sequence &query,
+HspList swipe_targets(const sequence &query,
 	vector<DpTarget>::const_iterator begin,
 	vector<DpTarget>::const_iterator end,
 	DynamicIterator<DpTarget>* targets,
@@ -96,7 +96,7 @@ list<Hsp> swipe_targets(const sequence &query,
 	Statistics &stat)
 {
 	constexpr auto CHANNELS = vector<DpTarget>::const_iterator::difference_type(::DISPATCH_ARCH::ScoreTraits<_sv>::CHANNELS);
-	list<Hsp> out;
+	HspList out;
 	if (flags & DP::FULL_MATRIX) {
 		if (flags & TRACEBACK)
 			return full_swipe_dispatch_cbs<_sv, VectorTraceback>(query, frame, *targets, composition_bias, overflow, stat);
@@ -127,7 +127,7 @@ void swipe_worker(const sequence *query,
 	Frame frame,
 	const int8_t *composition_bias,
 	int flags,
-	list<Hsp> *out,
+	HspList *out,
 	vector<DpTarget> *overflow,
 	Statistics *stat)
 {
@@ -145,7 +145,7 @@ void swipe_worker(const sequence *query,
 }
 
 template<typename _sv>
-list<Hsp> swipe_threads(const sequence &query,
+HspList swipe_threads(const sequence &query,
 	vector<DpTarget>::const_iterator begin,
 	vector<DpTarget>::const_iterator end,
 	DynamicIterator<DpTarget>* targets,
@@ -165,7 +165,7 @@ list<Hsp> swipe_threads(const sequence &query,
 		task_timer timer("Banded swipe (run)", config.target_parallel_verbosity);
 		const size_t n = config.threads_align ? config.threads_align : config.threads_;
 		vector<thread> threads;
-		vector<list<Hsp>> thread_out(n);
+		vector<HspList> thread_out(n);
 		vector<vector<DpTarget>> thread_overflow(n);
 		atomic<size_t> next(0);
 		for (size_t i = 0; i < n; ++i)
@@ -185,8 +185,8 @@ list<Hsp> swipe_threads(const sequence &query,
 		for (auto &t : threads)
 			t.join();
 		timer.go("Banded swipe (merge)");
-		list<Hsp> out;
-		for (list<Hsp> &l : thread_out)
+		HspList out;
+		for (HspList &l : thread_out)
 			out.splice(out.end(), l);
 		overflow.reserve(std::accumulate(thread_overflow.begin(), thread_overflow.end(), (size_t)0, [](size_t n, const vector<DpTarget> &v) { return n + v.size(); }));
 		for (const vector<DpTarget> &v : thread_overflow)
@@ -197,10 +197,10 @@ list<Hsp> swipe_threads(const sequence &query,
 		return swipe_targets<_sv>(query, begin, end, targets ? targets : my_targets.get(), frame, composition_bias, flags, overflow, stat);
 }
 
-list<Hsp> swipe(const sequence &query, vector<DpTarget> &targets8, vector<DpTarget> &targets16, DynamicIterator<DpTarget>* targets, Frame frame, const Bias_correction *composition_bias, int flags, Statistics &stat)
+HspList swipe(const sequence &query, vector<DpTarget> &targets8, vector<DpTarget> &targets16, DynamicIterator<DpTarget>* targets, Frame frame, const Bias_correction *composition_bias, int flags, Statistics &stat)
 {
 	vector<DpTarget> overflow8, overflow16, overflow32;
-	list<Hsp> out;
+	HspList out;
 	auto time_stat = (flags & TRACEBACK) ? Statistics::TIME_TRACEBACK_SW : Statistics::TIME_SW;
 #ifdef __SSE4_1__
 	if ((!targets8.empty() || targets) && config.cbs_matrix_scale < 16) {
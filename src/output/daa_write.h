@@ -102,13 +102,8 @@ inline void finish_daa(OutputFile &f, const DatabaseFile &db)
 	h2_.db_seqs_used = dict.seqs();
 	h2_.query_records = statistics.get(Statistics::ALIGNED);
 
-	size_t s = 0;
-	for (PtrVector<string>::const_iterator i = dict.name_.begin(); i != dict.name_.end(); ++i) {
-		//std::cout << **i << endl;
-		f << **i;
-		s += (*i)->length() + 1;
-	}
-	h2_.block_size[1] = s;
+	f.write(dict.names_.data(), dict.names_.size());
+	h2_.block_size[1] = dict.names_.size();
 
 	f.write(dict.len_.data(), dict.len_.size());
 	h2_.block_size[2] = dict.len_.size() * sizeof(uint32_t);
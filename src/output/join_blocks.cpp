@@ -50,7 +50,7 @@ struct JoinFetcher
 	static void init(const vector<string> & tmp_file_names)
 	{
 		for (auto file_name : tmp_file_names) {
-			files.push_back(new InputFile(file_name, InputFile::NO_AUTODETECT));
+			files.push_back(new InputFile(file_name, config.compress_temp ? 0 : InputFile::NO_AUTODETECT));
 			query_ids.push_back(0);
 			files.back().read(&query_ids.back(), 1);
 		}
@@ -210,7 +210,7 @@ void join_query(
 	vector<IntermediateRecord> target_hsp;
 	unique_ptr<TargetCulling> culling(TargetCulling::get());
 
-	unsigned n_target_seq = 0;
+	unsigned n_hit = 0;
 	unsigned block_idx = 0;
 
 	while (joiner.get(target_hsp, block_idx)) {
@@ -228,34 +228,38 @@ void join_query(
 		else if (c == TargetCulling::NEXT)
 			continue;
 
-		unsigned hsp_num = 0;
-		for (vector<IntermediateRecord>::const_iterator i = target_hsp.begin(); i != target_hsp.end(); ++i, ++hsp_num) {
-			if (f == Output_format::daa)
-				write_daa_record(out, *i);
-			else if (config.global_ranking_targets > 0)
-				Extension::GlobalRanking::write_merged_query_list(*i, dict, out, ranking_db_filter, statistics);
-			else {
-				Hsp hsp(*i, query_source_len);
-				f.print_match(Hsp_context(hsp,
-					query,
-					query_seq,
-					query_name,
-					dict_ptr->check_id(i->subject_dict_id),
-					dict_ptr->database_id(i->subject_dict_id),
-					dict_ptr->name(i->subject_dict_id),
-					dict_ptr->length(i->subject_dict_id),
-					n_target_seq,
-					hsp_num,
-					config.use_lazy_dict ? dict_ptr->seq(i->subject_dict_id) : sequence()
-					).parse(), metadata, out);
+		if (f == Output_format::daa || config.global_ranking_targets > 0)
+			for (vector<IntermediateRecord>::const_iterator i = target_hsp.begin(); i != target_hsp.end(); ++i) {
+				if (f == Output_format::daa)
+					write_daa_record(out, *i);
+				else
+					Extension::GlobalRanking::write_merged_query_list(*i, dict, out, ranking_db_filter, statistics);
+			}
+		else
+			for (const string &title : Output_format::report_titles(dict_ptr->name(target_hsp.front().subject_dict_id))) {
+				unsigned hsp_num = 0;
+				for (vector<IntermediateRecord>::const_iterator i = target_hsp.begin(); i != target_hsp.end(); ++i, ++hsp_num) {
+					Hsp hsp(*i, query_source_len);
+					f.print_match(Hsp_context(hsp,
+						query,
+						query_seq,
+						query_name,
+						dict_ptr->check_id(i->subject_dict_id),
+						dict_ptr->database_id(i->subject_dict_id),
+						title.c_str(),
+						dict_ptr->length(i->subject_dict_id),
+						n_hit,
+						hsp_num,
+						config.use_lazy_dict ? dict_ptr->seq(i->subject_dict_id) : sequence()
+						).parse(), metadata, out);
+				}
+				++n_hit;
 			}
-		}
 
 		culling->add(target_hsp, rank_taxon_ids);
-		++n_target_seq;
 		if (!config.global_ranking_targets) {
 			statistics.inc(Statistics::PAIRWISE);
-			statistics.inc(Statistics::MATCHES, hsp_num);
+			statistics.inc(Statistics::MATCHES, target_hsp.size());
 		}
 	}
 }
@@ -57,6 +57,13 @@ void Output_format::print_title(TextBuffer &buf, const char *id, bool full_title
 		print_escaped_until(buf, i->c_str(), Const::id_delimiters, esc);
 }
 
+vector<string> Output_format::report_titles(const char *title)
+{
+	if (!config.expand_titles || strchr(title, '\1') == 0)
+		return { title };
+	return tokenize(title, "\1");
+}
+
 void print_hsp(Hsp &hsp, const TranslatedSequence &query)
 {
 	TextBuffer buf;
@@ -146,7 +153,13 @@ void Bin1_format::print_match(const Hsp_context& r, const Metadata &metadata, Te
 
 void Binary_format::print_match(const Hsp_context& r, const Metadata& metadata, TextBuffer& out)
 {
-	out.write((uint32_t)query_block_to_database_id[r.query_id]);
-	out.write((uint32_t)r.orig_subject_id);
+	const uint32_t query = query_block_to_database_id[r.query_id], subject = (uint32_t)r.orig_subject_id;
+	out.write(query);
+	out.write(subject);
+	// The reverse direction of hits to later reference blocks is not searched.
+	if (symmetric_self_search && subject > query_block_to_database_id.back()) {
+		out.write(subject);
+		out.write(query);
+	}
 }
 
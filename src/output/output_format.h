@@ -59,6 +59,8 @@ struct Output_format
 	virtual ~Output_format()
 	{ }
 	static void print_title(TextBuffer &buf, const char *id, bool full_titles, bool all_titles, const char *separator, const EscapeSequences *esc = 0);
+	// Titles that a match to the subject is reported under.
+	static vector<string> report_titles(const char *title);
 	operator unsigned() const
 	{
 		return code;
@@ -117,7 +117,7 @@ struct RangeCulling : public TargetCulling
 	virtual int cull(const Target &t) const
 	{
 		int c = 0, l = 0;
-		for (std::list<Hsp>::const_iterator i = t.hsps.begin(); i != t.hsps.end(); ++i) {
+		for (HspList::const_iterator i = t.hsps.begin(); i != t.hsps.end(); ++i) {
 			if (config.toppercent == 100.0) {
 				c += p_.covered(i->query_source_range);
 			}
@@ -145,7 +145,7 @@ struct RangeCulling : public TargetCulling
 	}
 	virtual void add(const Target &t)
 	{
-		for (std::list<Hsp>::const_iterator i = t.hsps.begin(); i != t.hsps.end(); ++i)
+		for (HspList::const_iterator i = t.hsps.begin(); i != t.hsps.end(); ++i)
 			p_.insert(i->query_source_range, i->score);
 	}
 	virtual void add(const vector<IntermediateRecord> &target_hsp, const std::set<unsigned> &taxon_ids)
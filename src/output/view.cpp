@@ -84,6 +84,26 @@ void view_query(DAA_query_record &r, TextBuffer &out, Output_format &format, con
 	else
 		f->print_query_intro(r.query_num, r.query_name.c_str(), (unsigned)r.query_len(), out, false);
 	
+	// With --expand-titles, the HSPs of a hit are buffered so that they can
+	// be reported as one hit for each title.
+	vector<DAA_query_record::Match> hit;
+	unsigned n_hit = 0;
+	auto print_hit = [&]() {
+		if (hit.empty())
+			return;
+		for (const string &title : Output_format::report_titles(hit.front().subject_name.c_str())) {
+			unsigned hsp_num = 0;
+			for (DAA_query_record::Match &m : hit) {
+				m.subject_name = title;
+				m.hit_num = n_hit;
+				m.hsp_num = hsp_num++;
+				f->print_match(m.context(), metadata, out);
+			}
+			++n_hit;
+		}
+		hit.clear();
+	};
+
 	DAA_query_record::Match_iterator i = r.begin();
 	const unsigned top_score = i.good() ? i->score : 0;
 	for (; i.good(); ++i) {
@@ -93,9 +113,15 @@ void view_query(DAA_query_record &r, TextBuffer &out, Output_format &format, con
 			break;
 		if (format == Output_format::daa)
 			write_daa_record(out, *i, i->subject_id);
+		else if (config.expand_titles) {
+			if (!hit.empty() && hit.back().hit_num != i->hit_num)
+				print_hit();
+			hit.push_back(*i);
+		}
 		else
 			f->print_match(i->context(), metadata, out);
 	}
+	print_hit();
 	if (format == Output_format::daa)
 		finish_daa_query_record(out, seek_pos);
 	else
@@ -28,6 +28,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <memory>
 #include <algorithm>
 #include <cstdio>
+#include <thread>
+#include <exception>
 #include "../data/reference.h"
 #include "../data/queries.h"
 #include "../basic/statistics.h"
@@ -49,7 +51,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../util/parallel/parallelizer.h"
 #include "../util/system/system.h"
 #include "../align/target.h"
+#include "../align/align.h"
 #include "../data/enum_seeds.h"
+#include "../data/seed_index.h"
+#include "../data/block_cache.h"
+#include "../util/memory/huge_pages.h"
 
 using std::unique_ptr;
 using std::endl;
@@ -79,6 +85,13 @@ string get_ref_block_tmpfile_name(size_t query, size_t block) {
 	return join_path(config.parallel_tmpdir, file_name);
 }
 
+// Databases that carry a soft mask computed with the current parameters are
+// hard masked while loading instead of running tantan again on every block.
+static bool mask_ref_on_load(const DatabaseFile &db_file)
+{
+	return config.masking == 1 && !config.no_ref_masking && config.comp_based_stats != Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST && db_file.soft_masked();
+}
+
 void run_ref_chunk(DatabaseFile &db_file,
 	unsigned query_chunk,
 	pair<size_t, size_t> query_len_bounds,
@@ -86,7 +99,10 @@ void run_ref_chunk(DatabaseFile &db_file,
 	Consumer &master_out,
 	PtrVector<TempFile> &tmp_file,
 	const Parameters &params,
-	const Metadata &metadata)
+	const Metadata &metadata,
+	const SeedIndex *ref_index,
+	bool borrowed_block = false,
+	bool ref_masked = false)
 {
 	log_rss();
 
@@ -94,7 +110,7 @@ void run_ref_chunk(DatabaseFile &db_file,
 		ref_seqs_unmasked::data_ = new Sequence_set(*ref_seqs::data_);
 
 	task_timer timer;
-	if (config.masking == 1 && !config.no_ref_masking) {
+	if (config.masking == 1 && !config.no_ref_masking && !mask_ref_on_load(db_file) && !borrowed_block && !ref_masked) {
 		timer.go("Masking reference");
 		size_t n = mask_seqs(*ref_seqs::data_, Masking::get());
 		timer.finish();
@@ -104,11 +120,20 @@ void run_ref_chunk(DatabaseFile &db_file,
 	ReferenceDictionary::get().init(safe_cast<unsigned>(ref_seqs::get().get_length()), block_to_database_id);
 
 	timer.go("Initializing temporary storage");
+	const double trace_pt_memory = config.trace_pt_memory >= 0.0 ? config.trace_pt_memory : total_ram() / 8;
 	Trace_pt_buffer::instance = new Trace_pt_buffer(query_seqs::data_->get_length() / align_mode.query_contexts,
 		config.tmpdir,
-		config.query_bins);
+		config.query_bins,
+		size_t(trace_pt_memory * 1e9));
 
-	if (!config.swipe_all) {
+	if (!config.swipe_all && ref_index) {
+		for (unsigned i = 0; i < shapes.count(); ++i)
+			search_shape(i, query_chunk, query_buffer, nullptr, params, nullptr, ref_index);
+
+		timer.go("Clearing query masking");
+		Frequent_seeds::clear_masking(*query_seqs::data_);
+	}
+	else if (!config.swipe_all) {
 		timer.go("Building reference histograms");
 		if (config.algo == Config::query_indexed)
 			ref_hst = Partitioned_histogram(*ref_seqs::data_, false, query_seeds);
@@ -129,10 +154,10 @@ void run_ref_chunk(DatabaseFile &db_file,
 		}
 
 		for (unsigned i = 0; i < shapes.count(); ++i)
-			search_shape(i, query_chunk, query_buffer, ref_buffer, params, target_seeds);
+			search_shape(i, query_chunk, query_buffer, ref_buffer, params, target_seeds, nullptr);
 
 		timer.go("Deallocating buffers");
-		delete[] ref_buffer;
+		SeedArray::free_buffer(ref_buffer);
 		delete target_seeds;
 
 		timer.go("Clearing query masking");
@@ -144,9 +169,9 @@ void run_ref_chunk(DatabaseFile &db_file,
 		timer.go("Opening temporary output file");
 		if (config.multiprocessing) {
 			const string file_name = get_ref_block_tmpfile_name(query_chunk, current_ref_block);
-			tmp_file.push_back(new TempFile(file_name));
+			tmp_file.push_back(new TempFile(file_name, config.compress_temp != 0));
 		} else {
-			tmp_file.push_back(new TempFile());
+			tmp_file.push_back(new TempFile(true, config.compress_temp != 0));
 		}
 		out = &tmp_file.back();
 	}
@@ -166,6 +191,10 @@ void run_ref_chunk(DatabaseFile &db_file,
 		IntermediateRecord::finish_file(*out);
 
 	timer.go("Deallocating reference");
+	if (borrowed_block) {
+		ref_seqs::data_ = nullptr;
+		ref_ids::data_ = nullptr;
+	}
 	delete ref_seqs::data_;
 	delete ref_ids::data_;
 	if (config.comp_based_stats == Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST)
@@ -173,11 +202,119 @@ void run_ref_chunk(DatabaseFile &db_file,
 	timer.finish();
 }
 
+struct RefBlock
+{
+	RefBlock() :
+		seqs(nullptr),
+		ids(nullptr),
+		loaded(false)
+	{}
+	Sequence_set *seqs;
+	String_set<char, 0> *ids;
+	vector<uint32_t> block2db_id;
+	bool loaded;
+	std::exception_ptr error;
+};
+
+static void load_ref_block(DatabaseFile *db_file, RefBlock *block, size_t max_letters, const BitVector *filter)
+{
+	try {
+		block->loaded = db_file->load_seqs(&block->block2db_id, max_letters, &block->seqs, &block->ids, true, filter, true, Chunk(), false, mask_ref_on_load(*db_file));
+	}
+	catch (...) {
+		block->error = std::current_exception();
+	}
+}
+
+ResidentBlock::ResidentBlock(DatabaseFile &db_file, const BitVector *filter)
+{
+	db_file.rewind();
+	if (!db_file.load_seqs(&block2db_id, (size_t)(config.chunk_size*1e9), &seqs, &ids, true, filter, true, Chunk(), true, mask_ref_on_load(db_file)))
+		throw std::runtime_error("The database does not contain any sequences.");
+	if (db_file.tell_seq() < db_file.ref_header.sequences) {
+		delete seqs;
+		delete ids;
+		throw std::runtime_error("The database does not fit into a single block. Increase the block size (--block-size/-b).");
+	}
+	if (config.masking == 1 && !config.no_ref_masking && !mask_ref_on_load(db_file)) {
+		task_timer timer("Masking reference");
+		const size_t n = mask_seqs(*seqs, Masking::get());
+		timer.finish();
+		log_stream << "Masked letters: " << n << endl;
+	}
+}
+
+ResidentBlock::~ResidentBlock()
+{
+	delete seqs;
+	delete ids;
+}
+
+static bool prefetch_ref_blocks(const DatabaseFile &db_file, size_t max_letters)
+{
+	const double limit = config.ref_prefetch_memory >= 0.0 ? config.ref_prefetch_memory : total_ram() / 4;
+	if (db_file.ref_header.letters <= max_letters || limit <= 0.0)
+		return false;
+	const double id_bytes = (double)(db_file.ref_header.pos_array_offset - db_file.ref_header.letters - 3 * db_file.ref_header.sequences),
+		block_bytes = (double)max_letters * (1.0 + id_bytes / db_file.ref_header.letters + 8.0 * db_file.ref_header.sequences / db_file.ref_header.letters);
+	log_stream << "Reference block prefetch: estimated size = " << block_bytes / 1e9 << " GB, limit = " << limit << " GB" << endl;
+	return block_bytes / 1e9 <= limit;
+}
+
+struct QueryBlock
+{
+	QueryBlock() :
+		seqs(nullptr),
+		source_seqs(nullptr),
+		ids(nullptr),
+		qual(nullptr),
+		loaded(false)
+	{}
+	Sequence_set *seqs, *source_seqs;
+	String_set<char, 0> *ids, *qual;
+	bool loaded;
+	std::exception_ptr error;
+};
+
+static void load_query_block(list<TextInputFile> *query_file, const Sequence_file_format *format, bool paired_mode, QueryBlock *block)
+{
+	try {
+		block->loaded = load_seqs(query_file->begin(), query_file->end(), *format, &block->seqs, block->ids, &block->source_seqs,
+			config.store_query_quality ? &block->qual : nullptr,
+			(size_t)(config.chunk_size * 1e9), config.qfilt, input_value_traits, paired_mode ? 2 : 1) > 0;
+		if (block->loaded && config.masking == 1)
+			mask_seqs(*block->seqs, Masking::get());
+	}
+	catch (...) {
+		block->error = std::current_exception();
+	}
+}
+
+// The size of the next query block is estimated from the current one.
+static bool prefetch_query_block()
+{
+	const double limit = config.query_prefetch_memory >= 0.0 ? config.query_prefetch_memory : total_ram() / 8;
+	if (limit <= 0.0)
+		return false;
+	double block_bytes = (double)query_seqs::data_->raw_len() + query_ids::data_->raw_len();
+	if (query_source_seqs::data_)
+		block_bytes += query_source_seqs::data_->raw_len();
+	if (config.store_query_quality && query_qual)
+		block_bytes += query_qual->raw_len();
+	log_stream << "Query block prefetch: estimated size = " << block_bytes / 1e9 << " GB, limit = " << limit << " GB" << endl;
+	return block_bytes / 1e9 <= limit;
+}
+
 void deallocate_queries() {
 	delete query_seqs::data_;
 	delete query_ids::data_;
 	delete query_source_seqs::data_;
 	delete query_qual;
+	query_seqs::data_ = nullptr;
+	query_ids::data_ = nullptr;
+	query_source_seqs::data_ = nullptr;
+	query_qual = nullptr;
+	query_dedup.reset();
 }
 
 void run_query_chunk(DatabaseFile &db_file,
@@ -186,9 +323,12 @@ void run_query_chunk(DatabaseFile &db_file,
 	OutputFile *unaligned_file,
 	OutputFile *aligned_file,
 	const Metadata &metadata,
-	const Options &options)
+	const Options &options,
+	const SeedIndex *seed_index)
 {
 	auto P = Parallelizer::get();
+	// In a symmetric self-search the reference blocks start with the query block.
+	const size_t query_block_end = db_file.tell_seq();
 
 	task_timer timer("Building query seed set");
 	if (query_chunk == 0)
@@ -221,12 +361,28 @@ void run_query_chunk(DatabaseFile &db_file,
 		timer.finish();
 	if (query_chunk == 0)
 		setup_search();
+	if (config.query_dedup && !options.self) {
+		timer.go("Deduplicating queries");
+		query_dedup.reset(new QueryDedup());
+		timer.finish();
+		verbose_stream << "Duplicate queries: " << query_dedup->member_count() << endl;
+	}
 	if (config.algo == Config::double_indexed && config.small_query) {
 		timer.go("Building query seed hash set");
 		query_seeds_hashed = new Hashed_seed_set(query_seqs::get());
 	}
 	timer.finish();
 
+	const SeedIndex* ref_index = seed_index && seed_index->compatible() ? seed_index : nullptr;
+	if (seed_index && !ref_index && query_chunk == 0)
+		message_stream << "WARNING: The seed index does not match the search parameters and will not be used." << endl;
+
+	// Blocks in the cache are masked and contain all sequences of their range.
+	const bool block_cache = !config.block_cache.empty() && !options.db_filter && !metadata.taxon_filter
+		&& config.comp_based_stats != Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST;
+	if (!config.block_cache.empty() && !block_cache && query_chunk == 0)
+		message_stream << "WARNING: The block cache is not supported with database filters and composition based statistics mode 4 and will not be used." << endl;
+
 	const Parameters params{
 	db_file.ref_header.sequences,
 	db_file.ref_header.letters,
@@ -242,7 +398,7 @@ void run_query_chunk(DatabaseFile &db_file,
 
 	if (!config.swipe_all && !config.target_indexed) {
 		timer.go("Building query histograms");
-		query_hst = Partitioned_histogram(*query_seqs::data_, false, &no_filter);
+		query_hst = Partitioned_histogram(*query_seqs::data_, false, &no_filter, query_dedup ? &query_dedup->member_seqs() : nullptr);
 
 		timer.go("Allocating buffers");
 		query_buffer = SeedArray::alloc_buffer(query_hst);
@@ -259,10 +415,28 @@ void run_query_chunk(DatabaseFile &db_file,
 	db_file.rewind();
 	Chunk chunk;
 	bool mp_last_chunk = false;
+	unsigned first_ref_block = 0;
 
 	log_rss();
 
-	if (config.multiprocessing) {
+	if (symmetric_self_search) {
+		ref_seqs::data_ = query_seqs::data_;
+		ref_ids::data_ = query_ids::data_;
+		block_to_database_id = query_block_to_database_id;
+		current_ref_block = first_ref_block++;
+		run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, nullptr, true);
+		db_file.seek_seq(query_block_end);
+	}
+
+	if (options.ref_block) {
+		ref_seqs::data_ = options.ref_block->seqs;
+		ref_ids::data_ = options.ref_block->ids;
+		block_to_database_id = options.ref_block->block2db_id;
+		blocked_processing = false;
+		current_ref_block = 0;
+		run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, ref_index, true);
+		current_ref_block = 1;
+	} else if (config.multiprocessing) {
 		auto work = P->get_stack(stack_align_todo);
 		P->create_stack_from_file(stack_align_wip, get_ref_part_file_name(stack_align_wip, query_chunk));
 		auto wip = P->get_stack(stack_align_wip);
@@ -277,8 +451,8 @@ void run_query_chunk(DatabaseFile &db_file,
 
 			P->log("SEARCH BEGIN "+std::to_string(query_chunk)+" "+std::to_string(chunk.i));
 
-			db_file.load_seqs(&block_to_database_id, (size_t)(0), &ref_seqs::data_, &ref_ids::data_, true, options.db_filter ? options.db_filter : metadata.taxon_filter, true, chunk);
-			run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata);
+			db_file.load_seqs(&block_to_database_id, (size_t)(0), &ref_seqs::data_, &ref_ids::data_, true, options.db_filter ? options.db_filter : metadata.taxon_filter, true, chunk, true, mask_ref_on_load(db_file));
+			run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, nullptr);
 
 			ReferenceDictionary::get().save_block(query_chunk, chunk.i);
 			ReferenceDictionary::get().clear_block(chunk.i);
@@ -293,17 +467,54 @@ void run_query_chunk(DatabaseFile &db_file,
 			P->log("SEARCH END "+std::to_string(query_chunk)+" "+std::to_string(chunk.i));
 			log_rss();
 		}
+	} else if (block_cache) {
+		const bool mask = config.masking == 1 && !config.no_ref_masking;
+		for (current_ref_block = first_ref_block;
+			BlockCache::load(db_file, (size_t)(config.chunk_size*1e9), mask, block_to_database_id, &ref_seqs::data_, &ref_ids::data_);
+			++current_ref_block) {
+			run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, ref_index, false, true);
+		}
+		log_rss();
+	} else if (prefetch_ref_blocks(db_file, (size_t)(config.chunk_size*1e9))) {
+		const size_t max_letters = (size_t)(config.chunk_size*1e9);
+		const BitVector *filter = options.db_filter ? options.db_filter : metadata.taxon_filter;
+		RefBlock next;
+		next.loaded = db_file.load_seqs(&next.block2db_id, max_letters, &next.seqs, &next.ids, true, filter, true, Chunk(), true, mask_ref_on_load(db_file));
+		for (current_ref_block = first_ref_block; next.loaded; ++current_ref_block) {
+			ref_seqs::data_ = next.seqs;
+			ref_ids::data_ = next.ids;
+			block_to_database_id.swap(next.block2db_id);
+			next = RefBlock();
+			std::thread prefetch(load_ref_block, &db_file, &next, max_letters, filter);
+			try {
+				run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, ref_index);
+			}
+			catch (...) {
+				prefetch.join();
+				delete next.seqs;
+				delete next.ids;
+				throw;
+			}
+			timer.go("Waiting for reference block prefetch");
+			prefetch.join();
+			timer.finish();
+			if (next.error)
+				std::rethrow_exception(next.error);
+			if (next.loaded)
+				next.seqs->print_stats();
+		}
+		log_rss();
 	} else {
-		for (current_ref_block = 0;
-			 db_file.load_seqs(&block_to_database_id, (size_t)(config.chunk_size*1e9), &ref_seqs::data_, &ref_ids::data_, true, options.db_filter ? options.db_filter : metadata.taxon_filter);
+		for (current_ref_block = first_ref_block;
+			 db_file.load_seqs(&block_to_database_id, (size_t)(config.chunk_size*1e9), &ref_seqs::data_, &ref_ids::data_, true, options.db_filter ? options.db_filter : metadata.taxon_filter, true, Chunk(), true, mask_ref_on_load(db_file));
 			 ++current_ref_block) {
-			run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata);
+			run_ref_chunk(db_file, query_chunk, query_len_bounds, query_buffer, master_out, tmp_file, params, metadata, ref_index);
 		}
 		log_rss();
 	}
 
 	timer.go("Deallocating buffers");
-	delete[] query_buffer;
+	SeedArray::free_buffer(query_buffer);
 	delete query_seeds;
 	delete Extension::memory;
 	query_seeds = 0;
@@ -401,7 +612,7 @@ void master_thread(DatabaseFile *db_file, task_timer &total_timer, Metadata &met
 {
 	auto P = Parallelizer::get();
 	if (config.multiprocessing) {
-		P->init(config.parallel_tmpdir);
+		P->init(config.parallel_tmpdir, config.mp_coordinator);
 		db_file->create_partition_balanced((size_t)(config.chunk_size*1e9));
 	}
 
@@ -476,23 +687,58 @@ void master_thread(DatabaseFile *db_file, task_timer &total_timer, Metadata &met
 	if (*output_format == Output_format::daa)
 		init_daa(*static_cast<OutputFile*>(master_out));
 	unique_ptr<OutputFile> unaligned_file, aligned_file;
+	unique_ptr<SeedIndex> own_seed_index;
+	const SeedIndex *seed_index = options.seed_index;
+	if (config.seed_index && !seed_index) {
+		if (options.db_filter || metadata.taxon_filter)
+			message_stream << "WARNING: The seed index is not supported with database filters and will not be used." << endl;
+		else {
+			timer.go("Opening the seed index");
+			own_seed_index.reset(new SeedIndex(*db_file));
+			seed_index = own_seed_index.get();
+		}
+	}
 	if (!config.unaligned.empty())
 		unaligned_file = unique_ptr<OutputFile>(new OutputFile(config.unaligned));
 	if (!config.aligned_file.empty())
 		aligned_file = unique_ptr<OutputFile>(new OutputFile(config.aligned_file));
 	timer.finish();
 
+	// Query and reference blocks coincide if both are loaded with the same filter.
+	symmetric_self_search = options.self && options.symmetric && !config.multiprocessing && !seed_index
+		&& (options.db_filter || !metadata.taxon_filter)
+		&& config.comp_based_stats != Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST
+		&& config.target_seg != 1;
+
+	QueryBlock next;
+	bool prefetched = false;
 	for (;; ++current_query_chunk) {
 		task_timer timer("Loading query sequences", true);
+		const bool from_prefetch = prefetched;
 
-		if (options.self) {
+		if (from_prefetch) {
+			if (next.error)
+				std::rethrow_exception(next.error);
+			if (!next.loaded)
+				break;
+			query_seqs::data_ = next.seqs;
+			query_ids::data_ = next.ids;
+			query_source_seqs::data_ = next.source_seqs;
+			if (config.store_query_quality)
+				query_qual = next.qual;
+		}
+		else if (options.self) {
 			db_file->seek_seq(query_file_offset);
 			if (!db_file->load_seqs(&query_block_to_database_id,
 				(size_t)(config.chunk_size * 1e9),
 				&query_seqs::data_,
 				&query_ids::data_,
 				true,
-				options.db_filter))
+				options.db_filter,
+				true,
+				Chunk(),
+				true,
+				symmetric_self_search && mask_ref_on_load(*db_file)))
 				break;
 			query_file_offset = db_file->tell_seq();
 		}
@@ -509,7 +755,9 @@ void master_thread(DatabaseFile *db_file, task_timer &total_timer, Metadata &met
 			output_format->print_header(*master_out, align_mode.mode, config.matrix.c_str(), score_matrix.gap_open(), score_matrix.gap_extend(), config.max_evalue, query_ids::get()[0],
 				unsigned(align_mode.query_translated ? query_source_seqs::get()[0].length() : query_seqs::get()[0].length()));
 
-		if (config.masking == 1 && !options.self) {
+		// The query block doubles as a reference block in a symmetric self-search.
+		const bool mask_queries = symmetric_self_search ? !config.no_ref_masking && !mask_ref_on_load(*db_file) : !options.self;
+		if (config.masking == 1 && mask_queries && !from_prefetch) {
 			timer.go("Masking queries");
 			mask_seqs(*query_seqs::data_, Masking::get());
 			timer.finish();
@@ -518,12 +766,35 @@ void master_thread(DatabaseFile *db_file, task_timer &total_timer, Metadata &met
 		if (config.multiprocessing)
 			P->create_stack_from_file(stack_align_todo, get_ref_part_file_name(stack_align_todo, current_query_chunk));
 
-		run_query_chunk(*db_file, current_query_chunk, *master_out, unaligned_file.get(), aligned_file.get(), metadata, options);
+		std::thread prefetch;
+		prefetched = !options.self && !config.multiprocessing && prefetch_query_block();
+		if (prefetched) {
+			next = QueryBlock();
+			prefetch = std::thread(load_query_block, query_file, format_n, paired_mode, &next);
+		}
+
+		try {
+			run_query_chunk(*db_file, current_query_chunk, *master_out, unaligned_file.get(), aligned_file.get(), metadata, options, seed_index);
+		}
+		catch (...) {
+			if (prefetch.joinable())
+				prefetch.join();
+			throw;
+		}
 
 		if (config.multiprocessing)
 			P->delete_stack(stack_align_todo);
+
+		if (prefetch.joinable()) {
+			timer.go("Waiting for query block prefetch");
+			prefetch.join();
+			timer.finish();
+		}
 	}
 
+	timer.go("Deallocating target matrices");
+	free_target_matrices();
+
 	if (query_file && !options.query_file) {
 		timer.go("Closing the input file");
 		query_file->front().close();
@@ -548,58 +819,37 @@ void master_thread(DatabaseFile *db_file, task_timer &total_timer, Metadata &met
 		delete db_file;
 	}
 
-	timer.go("Deallocating taxonomy");
-	metadata.free();
+	if (!options.metadata) {
+		timer.go("Deallocating taxonomy");
+		metadata.free();
+	}
 
 	timer.finish();
 	log_rss();
 	message_stream << "Total time = " << total_timer.get() << "s" << endl;
 	statistics.print();
+	Util::Memory::log_huge_page_stats();
 	print_warnings();
 }
 
-void run(const Options &options)
+void load_metadata(DatabaseFile &db_file, Metadata &metadata)
 {
-	task_timer total;
-
-	align_mode = Align_mode(Align_mode::from_command(config.command));
-
-	message_stream << "Temporary directory: " << TempFile::get_temp_dir() << endl;
-
-	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
-		Config::set_option(config.chunk_size, 0.4);
-	else
-		Config::set_option(config.chunk_size, 2.0);
-
-	task_timer timer("Opening the database", 1);
-	DatabaseFile *db_file = options.db ? options.db : DatabaseFile::auto_create_from_fasta();
-	timer.finish();
-
-	init_output(db_file->has_taxon_id_lists(), db_file->has_taxon_nodes(), db_file->has_taxon_scientific_names());
-
-	message_stream << "Reference = " << config.database << endl;
-	message_stream << "Sequences = " << db_file->ref_header.sequences << endl;
-	message_stream << "Letters = " << db_file->ref_header.letters << endl;
-	message_stream << "Block size = " << (size_t)(config.chunk_size * 1e9) << endl;
-	Config::set_option(config.db_size, (uint64_t)db_file->ref_header.letters);
-	score_matrix.set_db_letters(db_file->ref_header.letters);
-
-	Metadata metadata;
+	task_timer timer;
 	const bool taxon_filter = !config.taxonlist.empty() || !config.taxon_exclude.empty();
 	const bool taxon_culling = config.taxon_k != 0;
 	if (output_format->needs_taxon_id_lists || taxon_filter || taxon_culling) {
-		if (db_file->header2.taxon_array_offset == 0) {
+		if (db_file.header2.taxon_array_offset == 0) {
 			if (taxon_filter)
 				throw std::runtime_error("--taxonlist/--taxon-exclude options require taxonomy mapping built into the database.");
 			if (taxon_culling)
 				throw std::runtime_error("--taxon-k option requires taxonomy mapping built into the database.");
 		}
 		timer.go("Loading taxonomy mapping");
-		metadata.taxon_list = new TaxonList(db_file->seek(db_file->header2.taxon_array_offset), db_file->ref_header.sequences, db_file->header2.taxon_array_size);
+		metadata.taxon_list = new TaxonList(db_file.seek(db_file.header2.taxon_array_offset), db_file.ref_header.sequences, db_file.header2.taxon_array_size);
 		timer.finish();
 	}
 	if (output_format->needs_taxon_nodes || taxon_filter || taxon_culling) {
-		if (db_file->header2.taxon_nodes_offset == 0) {
+		if (db_file.header2.taxon_nodes_offset == 0) {
 			if (taxon_filter)
 				throw std::runtime_error("--taxonlist/--taxon-exclude options require taxonomy nodes built into the database.");
 			if (taxon_culling)
@@ -607,14 +857,14 @@ void run(const Options &options)
 			if(output_format->needs_taxon_nodes)
 				throw std::runtime_error("Output format requires taxonomy nodes built into the database.");
 		}
-		if (db_file->ref_header.build < 131) {
+		if (db_file.ref_header.build < 131) {
 			if (taxon_culling)
 				throw std::runtime_error("--taxon-k option requires a database built with diamond version >= 0.9.30");
 			if (output_format->needs_taxon_ranks)
 				throw std::runtime_error("Output fields sskingdoms, skingdoms and sphylums require a database built with diamond version >= 0.9.30");
 		}
 		timer.go("Loading taxonomy nodes");
-		metadata.taxon_nodes = new TaxonomyNodes(db_file->seek(db_file->header2.taxon_nodes_offset), db_file->ref_header.build);
+		metadata.taxon_nodes = new TaxonomyNodes(db_file.seek(db_file.header2.taxon_nodes_offset), db_file.ref_header.build);
 		if (taxon_filter) {
 			timer.go("Building taxonomy filter");
 			metadata.taxon_filter = new TaxonomyFilter(config.taxonlist, config.taxon_exclude, *metadata.taxon_list, *metadata.taxon_nodes);
@@ -624,10 +874,42 @@ void run(const Options &options)
 	if (output_format->needs_taxon_scientific_names) {
 		timer.go("Loading taxonomy names");
 		metadata.taxonomy_scientific_names = new vector<string>;
-		db_file->seek(db_file->header2.taxon_names_offset);
-		*db_file >> *metadata.taxonomy_scientific_names;
+		db_file.seek(db_file.header2.taxon_names_offset);
+		db_file >> *metadata.taxonomy_scientific_names;
 		timer.finish();
 	}
+}
+
+void run(const Options &options)
+{
+	task_timer total;
+
+	align_mode = Align_mode(Align_mode::from_command(config.command));
+
+	message_stream << "Temporary directory: " << TempFile::get_temp_dir() << endl;
+
+	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
+		Config::set_option(config.chunk_size, 0.4);
+	else
+		Config::set_option(config.chunk_size, 2.0);
+
+	task_timer timer("Opening the database", 1);
+	DatabaseFile *db_file = options.db ? options.db : DatabaseFile::auto_create_from_fasta();
+	timer.finish();
+
+	init_output(db_file->has_taxon_id_lists(), db_file->has_taxon_nodes(), db_file->has_taxon_scientific_names());
+
+	message_stream << "Reference = " << config.database << endl;
+	message_stream << "Sequences = " << db_file->ref_header.sequences << endl;
+	message_stream << "Letters = " << db_file->ref_header.letters << endl;
+	message_stream << "Block size = " << (size_t)(config.chunk_size * 1e9) << endl;
+	Config::set_option(config.db_size, (uint64_t)db_file->ref_header.letters);
+	score_matrix.set_db_letters(db_file->ref_header.letters);
+
+	Metadata own_metadata;
+	if (!options.metadata)
+		load_metadata(*db_file, own_metadata);
+	Metadata &metadata = options.metadata ? *options.metadata : own_metadata;
 
 	master_thread(db_file, total, metadata, options);
 }
@@ -20,10 +20,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../basic/config.h"
 #include "tools.h"
 #include "../data/reference.h"
+#include "../data/seed_index.h"
 #include "workflow.h"
 #include "../cluster/cluster_registry.h"
 #include "../output/recursive_parser.h"
 #include "../util/simd.h"
+#include "../util/parallel/coordinator.h"
 
 using std::cout;
 using std::cerr;
@@ -75,10 +77,19 @@ int main(int ac, const char* av[])
 		case Config::makedb:
 			make_db();
 			break;
+		case Config::makeidx:
+			make_seed_index();
+			break;
 		case Config::blastp:
 		case Config::blastx:
 			Workflow::Search::run(Workflow::Search::Options());
 			break;
+		case Config::serve:
+			Workflow::Serve::run();
+			break;
+		case Config::coordinator:
+			Coordinator::run(config.mp_coordinator);
+			break;
 		case Config::view:
 			view();
 			break;
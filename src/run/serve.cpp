@@ -0,0 +1,363 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <list>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stdexcept>
+#include <iostream>
+#include <string.h>
+#ifndef _MSC_VER
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#endif
+#include "workflow.h"
+#include "../basic/config.h"
+#include "../basic/statistics.h"
+#include "../stats/cbs.h"
+#include "../stats/score_matrix.h"
+#include "../data/reference.h"
+#include "../data/metadata.h"
+#include "../data/seed_index.h"
+#include "../output/output_format.h"
+#include "../util/io/consumer.h"
+#include "../util/io/temp_file.h"
+#include "../util/io/text_input_file.h"
+#include "../util/log_stream.h"
+
+using std::string;
+using std::endl;
+
+// Each connection sends a query file in FASTA or FASTQ format and closes its
+// sending side. The server replies with the search output and closes the
+// connection. Searches are run one at a time while other connections are
+// being received by a fixed pool of threads. Connections beyond the pool and
+// its queue are rejected. SIGINT and SIGTERM stop the server after the
+// running requests have finished.
+
+namespace Workflow { namespace Serve {
+
+#ifdef _MSC_VER
+
+void run()
+{
+	throw std::runtime_error("The serve command is not supported on Windows.");
+}
+
+#else
+
+struct SocketConsumer : public Consumer
+{
+	SocketConsumer(int fd) :
+		fd_(fd),
+		failed_(false)
+	{}
+	virtual void consume(const char *ptr, size_t n) override
+	{
+		// Output is written from worker threads while the search holds the
+		// server lock, so a client that disconnects or stops reading until
+		// the send timeout expires only discards the remaining output.
+		while (n > 0 && !failed_) {
+			const ssize_t w = ::write(fd_, ptr, n);
+			if (w < 0) {
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+					log_stream << "Timeout sending the search output." << endl;
+				if (errno != EINTR)
+					failed_ = true;
+				continue;
+			}
+			ptr += w;
+			n -= (size_t)w;
+		}
+	}
+private:
+	const int fd_;
+	bool failed_;
+};
+
+struct Server
+{
+	Server():
+		algo(config.algo)
+	{
+		task_timer timer("Opening the database", 1);
+		db_file.reset(DatabaseFile::auto_create_from_fasta());
+		timer.finish();
+
+		init_output(db_file->has_taxon_id_lists(), db_file->has_taxon_nodes(), db_file->has_taxon_scientific_names());
+		if (*output_format == Output_format::daa)
+			throw std::runtime_error("The DAA format is not supported by the serve command.");
+		Config::set_option(config.db_size, (uint64_t)db_file->ref_header.letters);
+		score_matrix.set_db_letters(db_file->ref_header.letters);
+		Search::load_metadata(*db_file, metadata);
+
+		if (config.seed_index) {
+			if (metadata.taxon_filter)
+				message_stream << "WARNING: The seed index is not supported with database filters and will not be used." << endl;
+			else {
+				timer.go("Opening the seed index");
+				seed_index.reset(new SeedIndex(*db_file));
+				timer.finish();
+			}
+		}
+
+		ref_block.reset(new Search::ResidentBlock(*db_file, metadata.taxon_filter));
+	}
+
+	~Server()
+	{
+		metadata.free();
+		db_file->close();
+	}
+
+	void search(int fd)
+	{
+		timeval timeout;
+		timeout.tv_sec = config.serve_timeout;
+		timeout.tv_usec = 0;
+		if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0
+			|| setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0)
+			throw std::runtime_error(string("Error setting socket timeout: ") + strerror(errno));
+
+		TempFile query_file;
+		const size_t max_size = (size_t)(config.serve_max_request * 1e9);
+		size_t size = 0;
+		char buf[65536];
+		for (;;) {
+			const ssize_t n = ::read(fd, buf, sizeof(buf));
+			if (n == 0)
+				break;
+			if (n < 0) {
+				if (errno == EINTR)
+					continue;
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+					throw std::runtime_error("Timeout receiving the query file.");
+				throw std::runtime_error(string("Error reading from socket: ") + strerror(errno));
+			}
+			size += (size_t)n;
+			if (size > max_size)
+				throw std::runtime_error("The query file exceeds the maximum request size (--max-request-size).");
+			query_file.write(buf, (size_t)n);
+		}
+
+		std::list<TextInputFile> query_files;
+		query_files.emplace_back(query_file);
+		SocketConsumer out(fd);
+
+		Search::Options opt;
+		opt.db = db_file.get();
+		opt.consumer = &out;
+		opt.query_file = &query_files;
+		opt.metadata = &metadata;
+		opt.seed_index = seed_index.get();
+		opt.ref_block = ref_block.get();
+
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			statistics.reset();
+			config.algo = algo;
+			Search::run(opt);
+		}
+		query_files.front().close();
+	}
+
+	std::unique_ptr<DatabaseFile> db_file;
+	Metadata metadata;
+	std::unique_ptr<SeedIndex> seed_index;
+	std::unique_ptr<Search::ResidentBlock> ref_block;
+	const int algo;
+
+private:
+	std::mutex mtx_;
+};
+
+// Accepted connections waiting for a thread of the pool.
+struct ConnectionQueue
+{
+	ConnectionQueue(size_t capacity):
+		capacity_(capacity),
+		closed_(false)
+	{}
+	bool push(int fd)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (closed_ || fds_.size() >= capacity_)
+				return false;
+			fds_.push_back(fd);
+		}
+		cv_.notify_one();
+		return true;
+	}
+	// Returns -1 once the queue is closed.
+	int pop()
+	{
+		std::unique_lock<std::mutex> lock(mtx_);
+		cv_.wait(lock, [this] { return closed_ || !fds_.empty(); });
+		if (closed_)
+			return -1;
+		const int fd = fds_.front();
+		fds_.pop_front();
+		return fd;
+	}
+	// Connections that have not been picked up are closed.
+	void close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			closed_ = true;
+			for (int fd : fds_)
+				::close(fd);
+			fds_.clear();
+		}
+		cv_.notify_all();
+	}
+private:
+	const size_t capacity_;
+	bool closed_;
+	std::deque<int> fds_;
+	std::mutex mtx_;
+	std::condition_variable cv_;
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int)
+{
+	stop_requested = 1;
+}
+
+static void serve_connection(Server *server, int fd)
+{
+	try {
+		server->search(fd);
+	}
+	catch (std::exception &e) {
+		std::cerr << "Error: " << e.what() << endl;
+		const string msg = string("Error: ") + e.what() + '\n';
+		if (::write(fd, msg.data(), msg.length()) < 0)
+			log_stream << "Failed to report error to client." << endl;
+	}
+	::close(fd);
+}
+
+static void connection_worker(Server *server, ConnectionQueue *queue)
+{
+	int fd;
+	while ((fd = queue->pop()) >= 0)
+		serve_connection(server, fd);
+}
+
+void run()
+{
+	if (config.frame_shift != 0 || config.multiprocessing || config.global_ranking_targets > 0)
+		throw std::runtime_error("The serve command does not support frameshift alignment, multiprocessing and global ranking.");
+	if (config.comp_based_stats == Stats::CBS::COMP_BASED_STATS_AND_MATRIX_ADJUST || config.target_seg == 1)
+		throw std::runtime_error("The serve command does not support composition based statistics modes that modify the reference sequences.");
+	if (!config.unaligned.empty() || !config.aligned_file.empty())
+		throw std::runtime_error("Options --un and --al are not supported by the serve command.");
+	if (config.serve_connections == 0)
+		throw std::runtime_error("Option --max-connections must be at least 1.");
+
+	config.command = Config::blastp;
+	align_mode = Align_mode(Align_mode::blastp);
+	if (config.sensitivity >= Sensitivity::VERY_SENSITIVE)
+		Config::set_option(config.chunk_size, 0.4);
+	else
+		Config::set_option(config.chunk_size, 2.0);
+	// The query-indexed algorithm would be chosen per request and changes the index chunks.
+	if (config.algo == -1)
+		config.algo = Config::double_indexed;
+
+	Server server;
+
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (config.socket_path.length() >= sizeof(addr.sun_path))
+		throw std::runtime_error("Socket path is too long: " + config.socket_path);
+	strcpy(addr.sun_path, config.socket_path.c_str());
+
+	const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0)
+		throw std::runtime_error(string("Error creating socket: ") + strerror(errno));
+	unlink(config.socket_path.c_str());
+	if (bind(listen_fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, SOMAXCONN) != 0)
+		throw std::runtime_error("Error listening on socket " + config.socket_path + ": " + strerror(errno));
+	signal(SIGPIPE, SIG_IGN);
+
+	// The pool threads block the stop signals so that they interrupt accept().
+	sigset_t stop_signals, old_mask;
+	sigemptyset(&stop_signals);
+	sigaddset(&stop_signals, SIGINT);
+	sigaddset(&stop_signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+	ConnectionQueue queue(config.serve_connections);
+	std::vector<std::thread> pool;
+	for (unsigned i = 0; i < config.serve_connections; ++i)
+		pool.emplace_back(connection_worker, &server, &queue);
+	pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = request_stop;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+	message_stream << "Listening on " << config.socket_path << endl;
+
+	string error;
+	while (!stop_requested) {
+		const int fd = accept(listen_fd, nullptr, nullptr);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			error = string("Error accepting connection: ") + strerror(errno);
+			break;
+		}
+		if (!queue.push(fd)) {
+			const string msg = "Error: Too many connections.\n";
+			if (::write(fd, msg.data(), msg.length()) < 0)
+				log_stream << "Failed to report error to client." << endl;
+			::close(fd);
+		}
+	}
+
+	::close(listen_fd);
+	unlink(config.socket_path.c_str());
+	queue.close();
+	for (std::thread &t : pool)
+		t.join();
+	if (!error.empty())
+		throw std::runtime_error(error);
+	message_stream << "Server stopped." << endl;
+}
+
+#endif
+
+}}
@@ -21,32 +21,63 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <list>
+#include <vector>
 #include "../basic/config.h"
 #include "../util/data_structures/bit_vector.h"
+#include "../data/sequence_set.h"
 
 struct DatabaseFile;
 struct Consumer;
 struct TextInputFile;
+struct Metadata;
+struct SeedIndex;
 
 namespace Workflow { 
 namespace Search {
 
+// Masked reference block holding the whole database, kept loaded across searches.
+struct ResidentBlock {
+	ResidentBlock(DatabaseFile &db_file, const BitVector *filter);
+	~ResidentBlock();
+	Sequence_set *seqs;
+	String_set<char, 0> *ids;
+	std::vector<uint32_t> block2db_id;
+};
+
 struct Options {
 	Options():
 		self(config.self),
+		symmetric(false),
 		db(nullptr),
 		consumer(nullptr),
 		query_file(nullptr),
-		db_filter(nullptr)
+		db_filter(nullptr),
+		metadata(nullptr),
+		seed_index(nullptr),
+		ref_block(nullptr)
 	{}
 	bool self;
+	// Self-search whose consumer accepts hits in both directions, so that only
+	// block pairs (i, j) with i <= j need to be searched.
+	bool symmetric;
 	DatabaseFile *db;
 	Consumer *consumer;
 	std::list<TextInputFile> *query_file;
 	const BitVector* db_filter;
+	// Resources owned by the caller that are reused instead of being loaded by the search.
+	Metadata *metadata;
+	const SeedIndex *seed_index;
+	const ResidentBlock *ref_block;
 };
 
+void load_metadata(DatabaseFile &db_file, Metadata &metadata);
 void run(const Options &options);
 
+}
+
+namespace Serve {
+
+void run();
+
 }
 }
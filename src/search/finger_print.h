@@ -45,6 +45,30 @@ struct Byte_finger_print_32
 	__m256i r1;
 };
 
+#ifdef __AVX512BW__
+
+struct Byte_finger_print_64
+{
+	Byte_finger_print_64(const Letter* q) :
+#ifdef SEQ_MASK
+		r1(letter_mask(_mm512_loadu_si512((__m512i const*)(q - 32))))
+#else
+		r1(_mm512_loadu_si512((__m512i const*)(q - 32)))
+#endif
+	{}
+	static uint64_t match_block(__m512i x, __m512i y)
+	{
+		return (uint64_t)_mm512_cmpeq_epi8_mask(x, y);
+	}
+	unsigned match(const Byte_finger_print_64& rhs) const
+	{
+		return popcount64(match_block(r1, rhs.r1));
+	}
+	__m512i r1;
+};
+
+#else
+
 struct Byte_finger_print_64
 {
 	Byte_finger_print_64(const Letter* q) :
@@ -69,6 +93,8 @@ struct Byte_finger_print_64
 
 #endif
 
+#endif
+
 #ifdef __SSE2__
 
 struct Byte_finger_print_48
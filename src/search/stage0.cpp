@@ -19,63 +19,70 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
-#include <thread>
 #include <utility>
-#include <atomic>
 #include "search.h"
 #include "../util/algo/hash_join.h"
 #include "../util/algo/radix_sort.h"
 #include "../data/reference.h"
 #include "../data/seed_array.h"
+#include "../data/seed_index.h"
 #include "../data/queries.h"
 #include "../data/frequent_seeds.h"
 #include "trace_pt_buffer.h"
 #include "../util/data_structures/double_array.h"
 #include "../util/system/system.h"
+#include "../util/parallel/thread_pool.h"
+#include "../util/system/numa.h"
 
 using std::vector;
-using std::atomic;
 using std::endl;
 
 Trace_pt_buffer* Trace_pt_buffer::instance;
 
 void seed_join_worker(
+	size_t i,
+	size_t thread_id,
 	SeedArray *query_seeds,
 	SeedArray *ref_seeds,
-	atomic<unsigned> *seedp,
 	const SeedPartitionRange *seedp_range,
 	DoubleArray<SeedArray::_pos> *query_seed_hits,
-	DoubleArray<SeedArray::_pos> *ref_seeds_hits)
+	DoubleArray<SeedArray::_pos> *ref_seeds_hits,
+	size_t *join_node)
 {
-	unsigned p;
+	const unsigned p = seedp_range->begin() + (unsigned)i;
+	join_node[p] = Numa::slot_node(thread_id, config.threads_, seedp_range->size());
 	const unsigned bits = config.hashed_seeds ? sizeof(SeedArray::Entry::Key) * 8
 		: (unsigned)ceil(shapes[0].weight_ * Reduction::reduction.bit_size_exact()) - Const::seedp_bits;
-	while ((p = (*seedp)++) < seedp_range->end()) {
-		std::pair<DoubleArray<SeedArray::_pos>, DoubleArray<SeedArray::_pos>> join = hash_join(
-			Relation<SeedArray::Entry>(query_seeds->begin(p), query_seeds->size(p)),
-			Relation<SeedArray::Entry>(ref_seeds->begin(p), ref_seeds->size(p)),
-			bits);
-		query_seed_hits[p] = join.first;
-		ref_seeds_hits[p] = join.second;
-	}
+	std::pair<DoubleArray<SeedArray::_pos>, DoubleArray<SeedArray::_pos>> join = hash_join(
+		Relation<SeedArray::Entry>(query_seeds->begin(p), query_seeds->size(p)),
+		Relation<SeedArray::Entry>(ref_seeds->begin(p), ref_seeds->size(p)),
+		bits);
+	query_seed_hits[p] = join.first;
+	ref_seeds_hits[p] = join.second;
 }
 
-void search_worker(atomic<unsigned> *seedp, const SeedPartitionRange *seedp_range, unsigned shape, size_t thread_id, DoubleArray<SeedArray::_pos> *query_seed_hits, DoubleArray<SeedArray::_pos> *ref_seed_hits, const Search::Context *context)
+// Output buffers and statistics are kept per pool thread and merged after the
+// last partition has been searched. With --numa, partitions whose join output
+// was written on another node are counted as remote.
+void search_worker(size_t i, size_t thread_id, const SeedPartitionRange *seedp_range, unsigned shape, DoubleArray<SeedArray::_pos> *query_seed_hits, DoubleArray<SeedArray::_pos> *ref_seed_hits, const size_t *join_node, const Search::Context *context, Trace_pt_buffer::Iterator **out, Statistics *stats)
 {
-	Trace_pt_buffer::Iterator* out = new Trace_pt_buffer::Iterator(*Trace_pt_buffer::instance, thread_id);
-	Statistics stats;
-	unsigned p;
-	while ((p = (*seedp)++) < seedp_range->end())
-		for (auto it = JoinIterator<SeedArray::_pos>(query_seed_hits[p].begin(), ref_seed_hits[p].begin()); it; ++it)
-			Search::stage1(it.r->begin(), it.r->size(), it.s->begin(), it.s->size(), stats, *out, shape, *context);
-	delete out;
-	statistics += stats;
+	const unsigned p = seedp_range->begin() + (unsigned)i;
+	if (Numa::active()) {
+		stats[thread_id].inc(Statistics::NUMA_PARTITIONS);
+		if (join_node[p] != Numa::slot_node(thread_id, config.threads_, seedp_range->size()))
+			stats[thread_id].inc(Statistics::NUMA_REMOTE_PARTITIONS);
+	}
+	if (out[thread_id] == nullptr)
+		out[thread_id] = new Trace_pt_buffer::Iterator(*Trace_pt_buffer::instance, thread_id);
+	for (auto it = JoinIterator<SeedArray::_pos>(query_seed_hits[p].begin(), ref_seed_hits[p].begin()); it; ++it)
+		Search::stage1(it.r->begin(), it.r->size(), it.s->begin(), it.s->size(), stats[thread_id], *out[thread_id], shape, *context);
 }
 
-void search_shape(unsigned sid, unsigned query_block, char *query_buffer, char *ref_buffer, const Parameters &params, const Hashed_seed_set* target_seeds)
+void search_shape(unsigned sid, unsigned query_block, char *query_buffer, char *ref_buffer, const Parameters &params, const Hashed_seed_set* target_seeds, const SeedIndex* ref_index)
 {
 	::partition<unsigned> p(Const::seedp, config.lowmem);
 	DoubleArray<SeedArray::_pos> query_seed_hits[Const::seedp], ref_seed_hits[Const::seedp];
+	size_t join_node[Const::seedp];
 	log_rss();
 
 	for (unsigned chunk = 0; chunk < p.parts; ++chunk) {
@@ -88,9 +95,11 @@ void search_shape(unsigned sid, unsigned query_block, char *query_buffer, char *
 		const SeedPartitionRange range(p.getMin(chunk), p.getMax(chunk));
 		current_range = range;
 
-		task_timer timer("Building reference seed array", true);
+		task_timer timer(ref_index ? "Loading reference seed array" : "Building reference seed array", true);
 		SeedArray *ref_idx;
-		if (config.algo == Config::query_indexed)
+		if (ref_index)
+			ref_idx = ref_index->get(current_ref_block, sid, chunk);
+		else if (config.algo == Config::query_indexed)
 			ref_idx = new SeedArray(*ref_seqs::data_, sid, ref_hst.get(sid), range, ref_hst.partition(), ref_buffer, query_seeds);
 		else if (query_seeds_hashed != 0)
 			ref_idx = new SeedArray(*ref_seqs::data_, sid, ref_hst.get(sid), range, ref_hst.partition(), ref_buffer, query_seeds_hashed);
@@ -100,20 +109,15 @@ void search_shape(unsigned sid, unsigned query_block, char *query_buffer, char *
 		timer.go("Building query seed array");
 		SeedArray* query_idx;
 		if (target_seeds)
-			query_idx = new SeedArray(*query_seqs::data_, sid, range, target_seeds);
+			query_idx = new SeedArray(*query_seqs::data_, sid, range, target_seeds, query_dedup ? &query_dedup->member_seqs() : nullptr);
 		else
-			query_idx = new SeedArray(*query_seqs::data_, sid, query_hst.get(sid), range, query_hst.partition(), query_buffer, &no_filter);
+			query_idx = new SeedArray(*query_seqs::data_, sid, query_hst.get(sid), range, query_hst.partition(), query_buffer, &no_filter, query_dedup ? &query_dedup->member_seqs() : nullptr);
 		timer.finish();
 
 		log_stream << "Indexed query seeds = " << query_idx->size() << '/' << query_seqs::get().letters() << ", reference seeds = " << ref_idx->size() << '/' << ref_seqs::get().letters() << endl;
 
 		timer.go("Computing hash join");
-		atomic<unsigned> seedp(range.begin());
-		vector<std::thread> threads;
-		for (size_t i = 0; i < config.threads_; ++i)
-			threads.emplace_back(seed_join_worker, query_idx, ref_idx, &seedp, &range, query_seed_hits, ref_seed_hits);
-		for (auto &t : threads)
-			t.join();
+		Util::Parallel::scheduled_thread_pool_auto(config.threads_, range.size(), seed_join_worker, query_idx, ref_idx, &range, query_seed_hits, ref_seed_hits, join_node);
 
 		timer.go("Building seed filter");
 		frequent_seeds.build(sid, range, query_seed_hits, ref_seed_hits);
@@ -128,15 +132,18 @@ void search_shape(unsigned sid, unsigned query_block, char *query_buffer, char *
 		};
 
 		timer.go("Searching alignments");
-		seedp = range.begin();
-		threads.clear();
-		for (size_t i = 0; i < config.threads_; ++i)
-			threads.emplace_back(search_worker, &seedp, &range, sid, i, query_seed_hits, ref_seed_hits, context);
-		for (auto &t : threads)
-			t.join();
+		vector<Trace_pt_buffer::Iterator*> out(config.threads_, nullptr);
+		vector<Statistics> stats(config.threads_);
+		Util::Parallel::scheduled_thread_pool_auto(config.threads_, range.size(), search_worker, &range, sid, query_seed_hits, ref_seed_hits, (const size_t*)join_node, context, out.data(), stats.data());
+		for (size_t i = 0; i < out.size(); ++i) {
+			delete out[i];
+			statistics += stats[i];
+		}
 
 		delete ref_idx;
 		delete query_idx;
 		delete context;
+		if (ref_index)
+			ref_index->release(current_ref_block, sid, chunk);
 	}
 }
\ No newline at end of file
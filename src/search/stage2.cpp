@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
 #include <limits.h>
+#include <algorithm>
 #include "search.h"
 #include "../util/map.h"
 #include "../data/queries.h"
@@ -72,9 +73,9 @@ void search_query_offset(uint64_t q,
 	const Context& context)
 {
 	thread_local TextBuffer output_buf;
+	thread_local vector<std::pair<uint64_t, uint16_t>> out_hits;
 
 	constexpr auto N = vector<Stage1_hit>::const_iterator::difference_type(::DISPATCH_ARCH::SIMD::Vector<int8_t>::CHANNELS);
-	const bool long_subject_offsets = ::long_subject_offsets();
 	const Letter* query = query_seqs::data_->data(q);
 
 	const Letter* subjects[N];
@@ -90,7 +91,7 @@ void search_query_offset(uint64_t q,
 	const int window = ungapped_window(query_len);
 	const sequence query_clipped = Util::Sequence::clip(query - window, window * 2, window);
 	const int window_left = int(query - query_clipped.data()), window_clipped = (int)query_clipped.length();
-	size_t hit_count = 0;
+	out_hits.clear();
 
 	const int interval_mod = config.left_most_interval > 0 ? seed_offset % config.left_most_interval : window_left, interval_overhang = std::max(window_left - interval_mod, 0);
 
@@ -111,28 +112,25 @@ void search_query_offset(uint64_t q,
 				stats.inc(Statistics::TENTATIVE_MATCHES2);
 				if (left_most_filter(query_clipped + interval_overhang, subjects[j] + interval_overhang, window_left - interval_overhang, shapes[sid].length_, context, sid == 0, sid, score_cutoff)) {
 					stats.inc(Statistics::TENTATIVE_MATCHES3);
-					if (hit_count == 0) {
-						output_buf.clear();
-						output_buf.write_varint(query_id);
-						output_buf.write_varint(seed_offset);
-					}
-					if (long_subject_offsets)
-						output_buf.write_raw((const char*)&s[*(i + j)], 5);
-					else
-						output_buf.write(s[*(i + j)].low);
-					output_buf.write((uint16_t)scores[j]);
-					++hit_count;
+					out_hits.emplace_back((uint64_t)s[*(i + j)], (uint16_t)scores[j]);
 				}
 			}
 		}
 	}
 
-	if (hit_count > 0) {
-		if (long_subject_offsets)
-			output_buf.write(packed_uint40_t(0));
-		else
-			output_buf.write((uint32_t)0);
-		out.push(query_id / align_mode.query_contexts, output_buf.get_begin(), output_buf.size(), hit_count);
+	if (!out_hits.empty()) {
+		std::sort(out_hits.begin(), out_hits.end());
+		output_buf.clear();
+		output_buf.write_varint(query_id);
+		output_buf.write_varint(seed_offset);
+		uint64_t prev = 0;
+		for (const std::pair<uint64_t, uint16_t> &h : out_hits) {
+			write_varint64(h.first - prev, output_buf);
+			output_buf.write(h.second);
+			prev = h.first;
+		}
+		output_buf.write((uint8_t)0);
+		out.push(query_id / align_mode.query_contexts, output_buf.get_begin(), output_buf.size(), out_hits.size());
 	}
 }
 
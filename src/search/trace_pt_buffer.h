@@ -115,31 +115,26 @@ struct hit
 		s << me.query_ << '\t' << uint64_t(me.subject_) << '\t' << me.seed_offset_ << '\n';
 		return s;
 	}
+	// A record holds the hits of one query seed: query id and seed offset as
+	// varints, followed by the subject locations in ascending order, each as the
+	// varint64 delta to its predecessor and a 16 bit score, terminated by a
+	// zero delta.
 	template<typename _it>
 	static size_t read(Deserializer& s, _it it) {
-		const bool l = long_subject_offsets();
 		uint32_t query_id, seed_offset;
 		s.varint = true;
 		s >> query_id >> seed_offset;
-		Packed_loc subject_loc;
-		size_t count = 0;
-		uint32_t x;
 		s.varint = false;
+		uint64_t subject_loc = 0, delta;
+		size_t count = 0;
 		for (;;) {
-			if (l) {
-				s.read(subject_loc);
-				if (uint64_t(subject_loc) == 0)
-					return count;
-			}
-			else {
-				s.read(x);
-				if (x == 0)
-					return count;
-				subject_loc = x;
-			}
+			s.read_varint64(delta);
+			if (delta == 0)
+				return count;
+			subject_loc += delta;
 			uint16_t score;
 			s.read(score);
-			*it = { query_id, subject_loc, seed_offset, score };
+			*it = { query_id, Packed_loc(subject_loc), seed_offset, score };
 			++count;
 		}
 	}
@@ -149,8 +144,8 @@ struct hit
 
 struct Trace_pt_buffer : public Async_buffer<hit>
 {
-	Trace_pt_buffer(size_t input_size, const string &tmpdir, unsigned query_bins):
-		Async_buffer<hit>(input_size, tmpdir, query_bins)
+	Trace_pt_buffer(size_t input_size, const string &tmpdir, unsigned query_bins, size_t mem_limit = 0):
+		Async_buffer<hit>(input_size, tmpdir, query_bins, mem_limit)
 	{}
 	static Trace_pt_buffer *instance;
 };
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <iomanip>
 #include <list>
+#include <memory>
 #include "../util/io/temp_file.h"
 #include "../util/io/text_input_file.h"
 #include "test.h"
@@ -37,85 +38,135 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../util/util.h"
 #include "../util/string/string.h"
 #include "../util/system/system.h"
+#include "../data/seed_index.h"
 
 using std::endl;
 using std::string;
 using std::vector;
 using std::cout;
 using std::list;
+using std::unique_ptr;
 
 namespace Test {
 
-size_t run_testcase(size_t i, DatabaseFile &db, list<TextInputFile> &query_file, size_t max_width, bool bootstrap, bool log, bool to_cout) {
-	vector<string> args = tokenize(test_cases[i].command_line, " ");
+struct TestData {
+	list<TextInputFile> proteins, duplicates;
+	DatabaseFile *db, *collapsed_db;
+};
+
+static void parse_options(const TestCase &test_case, bool log) {
+	vector<string> args = tokenize(test_case.command_line, " ");
 	args.emplace(args.begin(), "diamond");
 	if (log)
 		args.push_back("--log");
 	config = Config((int)args.size(), charp_array(args.begin(), args.end()).data(), false);
+}
+
+size_t run_testcase(size_t i, TestData &data, size_t max_width, bool bootstrap, bool log, bool to_cout) {
+	const TestCase &test_case = test_cases[i];
+	parse_options(test_case, log);
 	statistics.reset();
 	Workflow::Search::Options opt;
-	opt.db = &db;
-	query_file.front().rewind();
-	opt.query_file = &query_file;
+	opt.db = (test_case.flags & TestCase::COLLAPSED_DB) ? data.collapsed_db : data.db;
+	if (test_case.flags & TestCase::SELF) {
+		opt.self = true;
+		opt.symmetric = true;
+	}
+	else {
+		list<TextInputFile> &query_file = (test_case.flags & TestCase::DUPLICATE_QUERIES) ? data.duplicates : data.proteins;
+		query_file.front().rewind();
+		opt.query_file = &query_file;
+	}
 
-	if (to_cout) {
-		Workflow::Search::run(opt);
-		return 0;
+	unique_ptr<TempFile> index_file;
+	unique_ptr<SeedIndex> seed_index;
+	if (test_case.flags & TestCase::SEED_INDEX) {
+		index_file.reset(new TempFile(false));
+		opt.db->rewind();
+		make_seed_index(*opt.db, *index_file);
+		seed_index.reset(new SeedIndex(*opt.db, index_file->file_name()));
+		opt.seed_index = seed_index.get();
+		// Building the index modifies the configuration.
+		parse_options(test_case, log);
+		statistics.reset();
 	}
-	
-	TempFile output_file(!bootstrap);
-	opt.consumer = &output_file;
 
-	Workflow::Search::run(opt);
+	size_t passed = 0;
+	if (to_cout)
+		Workflow::Search::run(opt);
+	else {
+		TempFile output_file(!bootstrap);
+		opt.consumer = &output_file;
 
-	InputFile out_in(output_file);
-	uint64_t hash = out_in.hash();
+		Workflow::Search::run(opt);
 
-	if (bootstrap)
-		out_in.close();
-	else
-		out_in.close_and_delete();
+		InputFile out_in(output_file);
+		uint64_t hash = out_in.hash();
+
+		if (bootstrap)
+			out_in.close();
+		else
+			out_in.close_and_delete();
+
+		if (bootstrap)
+			cout << "0x" << std::hex << hash << ',' << endl;
+		else {
+			passed = hash == ref_hashes[i] ? 1 : 0;
+			cout << std::setw(max_width) << std::left << test_case.desc << " [ ";
+			set_color(passed ? Color::GREEN : Color::RED);
+			cout << (passed ? "Passed" : "Failed");
+			reset_color();
+			cout << " ]" << endl;
+		}
+	}
 
-	if (bootstrap)
-		cout << "0x" << std::hex << hash << ',' << endl;
-	else {
-		const bool passed = hash == ref_hashes[i];
-		cout << std::setw(max_width) << std::left << test_cases[i].desc << " [ ";
-		set_color(passed ? Color::GREEN : Color::RED);
-		cout << (passed ? "Passed" : "Failed");
-		reset_color();
-		cout << " ]" << endl;
-		return passed ? 1 : 0;
+	if (index_file) {
+		seed_index.reset();
+		index_file->remove();
 	}
-	return 0;
+	return passed;
 }
 
 int run() {
 	const bool bootstrap = config.bootstrap, log = config.debug_log, to_cout = config.output_file == "stdout";
 	task_timer timer("Generating test dataset");
-	TempFile proteins;
+	TempFile proteins, duplicates;
+	for (size_t i = 0; i < seqs.size(); ++i) {
+		const vector<Letter> seq = sequence::from_string(seqs[i].second.c_str());
+		Util::Sequence::format(seq, seqs[i].first.c_str(), nullptr, proteins, "fasta", amino_acid_traits);
+		Util::Sequence::format(seq, seqs[i].first.c_str(), nullptr, duplicates, "fasta", amino_acid_traits);
+	}
 	for (size_t i = 0; i < seqs.size(); ++i)
-		Util::Sequence::format(sequence::from_string(seqs[i].second.c_str()), seqs[i].first.c_str(), nullptr, proteins, "fasta", amino_acid_traits);
-	list<TextInputFile> query_file;
-	query_file.emplace_back(proteins);
+		Util::Sequence::format(sequence::from_string(seqs[i].second.c_str()), (seqs[i].first + "_copy").c_str(), nullptr, duplicates, "fasta", amino_acid_traits);
+	TestData data;
+	data.proteins.emplace_back(proteins);
+	data.duplicates.emplace_back(duplicates);
 	timer.finish();
 
 	config.command = Config::makedb;
-	TempFile *db_file;
-	make_db(&db_file, &query_file);
-	DatabaseFile db(*db_file);
+	TempFile *db_file, *collapsed_db_file;
+	make_db(&db_file, &data.proteins);
+	config.collapse_identical = true;
+	make_db(&collapsed_db_file, &data.duplicates);
+	config.collapse_identical = false;
+	DatabaseFile db(*db_file), collapsed_db(*collapsed_db_file);
+	data.db = &db;
+	data.collapsed_db = &collapsed_db;
 
 	const size_t n = test_cases.size(),
 		max_width = std::accumulate(test_cases.begin(), test_cases.end(), (size_t)0, [](size_t l, const TestCase& t) { return std::max(l, strlen(t.desc)); });
 	size_t passed = 0;
 	for (size_t i = 0; i < n; ++i)
-		passed += run_testcase(i, db, query_file, max_width, bootstrap, log, to_cout);
+		passed += run_testcase(i, data, max_width, bootstrap, log, to_cout);
 
 	cout << endl << "#Test cases passed: " << passed << '/' << n << endl; // << endl;
 	
-	query_file.front().close_and_delete();
+	data.proteins.front().close_and_delete();
+	data.duplicates.front().close_and_delete();
 	db.close();
+	collapsed_db.close();
 	delete db_file;
+	delete collapsed_db_file;
 	return passed == n ? 0 : 1;
 }
 
@@ -29,7 +29,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace Test {
 
 struct TestCase {
+	enum {
+		// Search uses a seed index built with the options of the test case.
+		SEED_INDEX = 1,
+		// Queries contain a renamed copy of every sequence.
+		DUPLICATE_QUERIES = 2,
+		// Database is built with --collapse-identical from sequences with renamed copies.
+		COLLAPSED_DB = 4,
+		// Symmetric self-search of the database.
+		SELF = 8
+	};
+	TestCase(const char *desc, const char *command_line, int flags = 0):
+		desc(desc),
+		command_line(command_line),
+		flags(flags)
+	{}
 	const char *desc, *command_line;
+	int flags;
 };
 
 std::vector<Letter> generate_random_seq(size_t length, std::minstd_rand0 &rand_engine);
@@ -44,7 +44,19 @@ const vector<TestCase> test_cases = {
 { "blastp (blosum50)", "blastp --matrix blosum50 -p4"},
 { "blastp (pairwise format)", "blastp -c1 -f0 -p4" },
 { "blastp (XML format)", "blastp -c1 -f xml -p4" },
-{ "blastp (PAF format)", "blastp -c1 -f paf -p1" }
+{ "blastp (PAF format)", "blastp -c1 -f paf -p1" },
+{ "blastp (seed index)", "blastp -c1 -p4 --seed-index", TestCase::SEED_INDEX },
+{ "blastp (seed index, blocked)", "blastp -c1 -b0.00002 -p4 --seed-index", TestCase::SEED_INDEX },
+{ "blastp (temporary files)", "blastp -c1 -b0.00002 -p4 --trace-pt-memory 0" },
+{ "blastp (compressed temporary files)", "blastp -c1 -b0.00002 -p4 --trace-pt-memory 0 --compress-temp 1" },
+{ "blastp (query dedup)", "blastp -c1 -p4 --query-dedup", TestCase::DUPLICATE_QUERIES },
+{ "blastp (query dedup, blocked)", "blastp -c1 -b0.00002 -p4 --query-dedup", TestCase::DUPLICATE_QUERIES },
+{ "blastp (collapsed db)", "blastp -c1 -p4", TestCase::COLLAPSED_DB },
+{ "blastp (expand titles)", "blastp -c1 -p4 --max-hsps 0 --expand-titles", TestCase::COLLAPSED_DB },
+{ "blastp (expand titles, blocked)", "blastp -c1 -b0.00002 -p4 --max-hsps 0 --expand-titles", TestCase::COLLAPSED_DB },
+{ "blastp (expand titles, XML)", "blastp -c1 -f xml -p4 --max-hsps 0 --expand-titles", TestCase::COLLAPSED_DB },
+{ "blastp (self)", "blastp -c1 -f bin -p4", TestCase::SELF },
+{ "blastp (self, blocked)", "blastp -c1 -b0.00002 -f bin -p4", TestCase::SELF }
 };
 
 const vector<uint64_t> ref_hashes = {
@@ -68,6 +80,18 @@ const vector<uint64_t> ref_hashes = {
 0x45e4056064e260c6,
 0xdffb0103534fe08f,
 0x778a9e9e5f7a6d64,
+0x602762c977aa8682,
+0x38498d4f4d3eb7c9,
+0x38498d4f4d3eb7c9,
+0x38498d4f4d3eb7c9,
+0x534ab0c25367e365,
+0xb540515219906f3b,
+0x602762c977aa8682,
+0xdca307bc5a4b6ea8,
+0xe2cd7df94cbb2b40,
+0x6db960c6b0ffc3b0,
+0xebf37ef6bd424ec2,
+0xadd9db6e555e647,
 };
 
 }
\ No newline at end of file
@@ -136,6 +136,21 @@ void benchmark_ungapped_sse(const sequence &s1, const sequence &s2) {
 		cout << "AVX2 ungapped extend:\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * 32 * 64) * 1000 << " ps/Cell" << endl;
 	}
 #endif
+#if ARCH_ID == 3
+	{
+		high_resolution_clock::time_point t1 = high_resolution_clock::now();
+
+		const Letter* targets[64];
+		int out[64];
+		for (int i = 0; i < 64; ++i)
+			targets[i] = s2.data();
+
+		for (size_t i = 0; i < n; ++i) {
+			::DP::ARCH_AVX512::window_ungapped(s1.data(), targets, 64, 64, out);
+		}
+		cout << "AVX-512 ungapped extend:\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * 64 * 64) * 1000 << " ps/Cell" << endl;
+	}
+#endif
 }
 #endif
 
@@ -169,6 +184,21 @@ void benchmark_transpose() {
 		cout << "Matrix transpose 32x32 bytes:\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * 32 * 32) * 1000 << " ps/Letter" << endl;
 	}
 #endif
+#if ARCH_ID == 3
+	{
+		alignas(64) static signed char in[64 * 64], out[64 * 64];
+		signed char* v[64];
+		for (int i = 0; i < 64; ++i)
+			v[i] = &in[i * 64];
+
+		high_resolution_clock::time_point t1 = high_resolution_clock::now();
+		for (size_t i = 0; i < n; ++i) {
+			transpose((const signed char**)v, 64, out, __m512i());
+			in[0] = out[0];
+		}
+		cout << "Matrix transpose 64x64 bytes:\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * 64 * 64) * 1000 << " ps/Letter" << endl;
+	}
+#endif
 }
 #endif
 
@@ -214,19 +244,19 @@ void swipe(const sequence &s1, const sequence &s2) {
 
 	high_resolution_clock::time_point t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), nullptr, DP::FULL_MATRIX, stat);
+		volatile HspList v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), nullptr, DP::FULL_MATRIX, stat);
 	}
 	cout << "SWIPE (int8_t):\t\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * query.length() * s2.length() * CHANNELS) * 1000 << " ps/Cell" << endl;
 
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), &cbs, DP::FULL_MATRIX, stat);
+		volatile HspList v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), &cbs, DP::FULL_MATRIX, stat);
 	}
 	cout << "SWIPE (int8_t, CBS):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * query.length() * s2.length() * CHANNELS) * 1000 << " ps/Cell" << endl;
 
 	t1 = high_resolution_clock::now();
 	for (size_t i = 0; i < n; ++i) {
-		volatile list<Hsp> v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), nullptr, DP::FULL_MATRIX | DP::TRACEBACK, stat);
+		volatile HspList v = ::DP::BandedSwipe::swipe(query, target8, target16, nullptr, Frame(0), nullptr, DP::FULL_MATRIX | DP::TRACEBACK, stat);
 	}
 	cout << "SWIPE (int8_t, TB):\t\t" << (double)duration_cast<std::chrono::nanoseconds>(high_resolution_clock::now() - t1).count() / (n * query.length() * s2.length() * CHANNELS) * 1000 << " ps/Cell" << endl;
 }
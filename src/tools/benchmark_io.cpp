@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <string>
 #include <random>
+#include <algorithm>
 #include "../util/system/system.h"
 #include "../util/io/output_file.h"
 #include "../util/io/input_file.h"
@@ -44,16 +45,23 @@ void benchmark_io() {
 		std::default_random_engine generator;
 		std::uniform_int_distribution<uint32_t> query(0, 2000000), seed(0, 20000), subject(1, UINT32_MAX);
 		std::uniform_int_distribution<uint16_t> score(30, 1000);
+		vector<uint32_t> subjects(query_count);
 		for (size_t i = 0; i < total_count / query_count; ++i) {
 			out.set(Serializer::VARINT);
 			out << query(generator) << seed(generator);
 			out.unset(Serializer::VARINT);
-			for (size_t j = 0; j < query_count; ++j) {
-				out << subject(generator);
+			for (size_t j = 0; j < query_count; ++j)
+				subjects[j] = subject(generator);
+			std::sort(subjects.begin(), subjects.end());
+			subjects.erase(std::unique(subjects.begin(), subjects.end()), subjects.end());
+			uint32_t prev = 0;
+			for (uint32_t s : subjects) {
+				write_varint64(s - prev, out);
 				out.write(score(generator));
+				prev = s;
 			}
-			out.unset(Serializer::VARINT);
-			out << (uint32_t)0;
+			out.write((uint8_t)0);
+			subjects.resize(query_count);
 		}
 		const size_t s = out.tell();
 		message_stream << "Written " << (double)s / (1 << 30) << "GB. (" << s << ")" << endl;
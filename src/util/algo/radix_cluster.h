@@ -21,10 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 #include <string.h>
-#include <thread>
 #include <algorithm>
 #include "../../basic/config.h"
 #include "../util/util.h"
+#include "../parallel/thread_pool.h"
 
 template<typename _t>
 struct Relation
@@ -141,15 +141,12 @@ void parallel_radix_cluster(const Relation<_t>& in, uint32_t shift, _t* out, siz
 	thread_hst.reserve(nt);
 	for (unsigned i = 0; i < nt; ++i)
 		thread_hst.emplace_back(clusters, 0);
-	std::vector<std::thread> threads;
-	for (unsigned i = 0; i < nt; ++i) {
-		threads.emplace_back(parallel_radix_cluster_build_hst<_t, _get_key>, in.part(p.getMin(i), p.getCount(i)), shift, thread_hst[i].data());
-	}
-	for (unsigned i = 0; i < nt; ++i) {
-		threads[i].join();
+	Util::Parallel::ThreadPool::get().run(nt, nt, [&](size_t i, size_t) {
+		parallel_radix_cluster_build_hst<_t, _get_key>(in.part(p.getMin(i), p.getCount(i)), shift, thread_hst[i].data());
+	});
+	for (unsigned i = 0; i < nt; ++i)
 		for (unsigned j = 0; j < clusters; ++j)
 			hst[j] += thread_hst[i][j];
-	}
 	
 	size_t sum = 0;
 	for (unsigned i = 0; i < clusters; ++i) {
@@ -165,9 +162,7 @@ void parallel_radix_cluster(const Relation<_t>& in, uint32_t shift, _t* out, siz
 		}
 	}
 
-	threads.clear();
-	for (unsigned i = 0; i < nt; ++i)
-		threads.emplace_back(parallel_radix_cluster_scatter<_t, _get_key>, in.part(p.getMin(i), p.getCount(i)), shift, thread_hst[i].data(), out);
-	for (unsigned i = 0; i < nt; ++i)
-		threads[i].join();
+	Util::Parallel::ThreadPool::get().run(nt, nt, [&](size_t i, size_t) {
+		parallel_radix_cluster_scatter<_t, _get_key>(in.part(p.getMin(i), p.getCount(i)), shift, thread_hst[i].data(), out);
+	});
 }
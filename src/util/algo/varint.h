@@ -47,6 +47,18 @@ inline void write_varint(uint32_t x, _out &out)
 	}
 }
 
+// Little endian base-128 encoding of 64 bit values: 7 bits per byte, the high
+// bit is set on all bytes but the last one.
+template<typename _out>
+inline void write_varint64(uint64_t x, _out &out)
+{
+	while (x >= 0x80) {
+		out.write(uint8_t(x | 0x80));
+		x >>= 7;
+	}
+	out.write(uint8_t(x));
+}
+
 template<typename _buf>
 void read_varint(_buf &buf, uint32_t &dst)
 {
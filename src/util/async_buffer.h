@@ -28,13 +28,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <tuple>
 #include <iterator>
 #include <atomic>
+#include <stdexcept>
+#include <zlib.h>
 #include "../basic/config.h"
 #include "io/temp_file.h"
 #include "io/input_file.h"
 #include "log_stream.h"
-#include "../util/ptr_vector.h"
-#include "io/async_file.h"
 #include "io/input_stream_buffer.h"
+#include "io/deserializer.h"
 
 template<typename _t>
 struct Async_buffer
@@ -42,22 +43,33 @@ struct Async_buffer
 
 	typedef std::vector<_t> Vector;
 
-	Async_buffer(size_t input_count, const std::string &tmpdir, unsigned bins) :
+	// Records are kept in memory as long as the total size of the buffered
+	// chunks stays below mem_limit bytes. Chunks exceeding the limit are
+	// appended to a temporary file of the writing thread, and a segment
+	// referring to them is added to the bin like an in-memory chunk.
+	Async_buffer(size_t input_count, const std::string &tmpdir, unsigned bins, size_t mem_limit = 0) :
 		bins_(bins),
 		bin_size_((input_count + bins_ - 1) / bins_),
 		input_count_(input_count),
+		mem_limit_(mem_limit),
 		bins_processed_(0),
-		total_disk_size_(0)
+		total_disk_size_(0),
+		total_raw_disk_size_(0),
+		mem_size_(0)
 	{
-		log_stream << "Async_buffer() " << input_count << ',' << bin_size_ << std::endl;
+		log_stream << "Async_buffer() " << input_count << ',' << bin_size_ << ',' << mem_limit << std::endl;
 		count_ = new std::atomic_size_t[bins];
+		head_ = new std::atomic<Segment*>[bins];
 		for (unsigned i = 0; i < bins; ++i) {
-			tmp_file_.push_back(new AsyncFile());
 			count_[i] = (size_t)0;
+			head_[i] = nullptr;
 		}
 	}
 
 	~Async_buffer() {
+		for (unsigned i = 0; i < bins_; ++i)
+			delete_segments(head_[i].exchange(nullptr));
+		delete[] head_;
 		delete[] count_;
 	}
 
@@ -71,16 +83,20 @@ struct Async_buffer
 		return std::min((bin + 1)*bin_size_, input_count_);
 	}
 
+private:
+
+	struct SpillFile;
+
+public:
+
 	struct Iterator
 	{
 		Iterator(Async_buffer &parent, size_t thread_num) :
 			buffer_(parent.bins()),
 			count_(parent.bins(), 0),
-			parent_(parent)
+			parent_(parent),
+			spill_file_(nullptr)
 		{
-			for (unsigned i = 0; i < parent.bins_; ++i) {
-				out_.push_back(&parent.tmp_file_[i]);
-			}
 		}
 		void push(unsigned id, const char *data, size_t size, size_t count)
 		{
@@ -93,7 +109,15 @@ struct Async_buffer
 		}
 		void flush(unsigned bin)
 		{
-			out_[bin]->write(buffer_[bin].data(), buffer_[bin].size());
+			if (buffer_[bin].empty())
+				return;
+			if (parent_.reserve(buffer_[bin].capacity()))
+				parent_.push_segment(bin, new Segment(std::move(buffer_[bin])));
+			else {
+				if (spill_file_ == nullptr)
+					spill_file_ = new SpillFile;
+				parent_.spill(bin, buffer_[bin], *spill_file_);
+			}
 			buffer_[bin].clear();
 		}
 		~Iterator()
@@ -102,13 +126,15 @@ struct Async_buffer
 				flush(bin);
 				parent_.count_[bin] += count_[bin];
 			}
+			if (spill_file_)
+				release(spill_file_);
 		}
 	private:
 		enum { buffer_size = 65536 };
 		std::vector<std::vector<char>> buffer_;
 		std::vector<size_t> count_;
-		std::vector<AsyncFile*> out_;
 		Async_buffer &parent_;
+		SpillFile *spill_file_;
 	};
 
 	void load(size_t max_size) {
@@ -120,14 +146,15 @@ struct Async_buffer
 			data_next_ = nullptr;
 			return;
 		}
-		size_t size = count_[bins_processed_], end = bins_processed_ + 1, current_size, disk_size = tmp_file_[bins_processed_].tell();
+		size_t size = count_[bins_processed_], end = bins_processed_ + 1, current_size, raw_disk_size = raw_disk_size_bin(bins_processed_);
 		while (end < bins_ && (size + (current_size = count_[end])) * sizeof(_t) < max_size) {
 			size += current_size;
-			disk_size += tmp_file_[end].tell();
+			raw_disk_size += raw_disk_size_bin(end);
 			++end;
 		}
-		log_stream << "Async_buffer.load() " << size << "(" << (double)size * sizeof(_t) / (1 << 30) << " GB, " << (double)disk_size / (1 << 30) << " GB on disk)" << std::endl;
-		total_disk_size_ += disk_size;
+		log_stream << "Async_buffer.load() " << size << "(" << (double)size * sizeof(_t) / (1 << 30) << " GB, "
+			<< (double)raw_disk_size / (1 << 30) << " GB on disk uncompressed)" << std::endl;
+		total_raw_disk_size_ += raw_disk_size;
 		data_next_ = new std::vector<_t>;
 		data_next_->reserve(size);
 		input_range_next_.first = begin(bins_processed_);
@@ -152,26 +179,187 @@ struct Async_buffer
 		return total_disk_size_;
 	}
 
+	size_t total_raw_disk_size() {
+		return total_raw_disk_size_;
+	}
+
 private:
 
+	// Temporary file written by one thread. It is referenced by the thread
+	// and by each of its segments, and deleted with the last reference.
+	struct SpillFile
+	{
+		SpillFile() :
+			file(new TempFile()),
+			in(nullptr),
+			size(0),
+			refs(1)
+		{}
+		~SpillFile()
+		{
+			if (in)
+				in->close_and_delete();
+			else {
+				file->close();
+				if (!file->unlinked)
+					file->remove();
+			}
+			delete in;
+			delete file;
+		}
+		TempFile *file;
+		InputFile *in;
+		size_t size;
+		std::atomic_size_t refs;
+	};
+
+	static void release(SpillFile *f)
+	{
+		if (--f->refs == 0)
+			delete f;
+	}
+
+	// A chunk of serialized records, either in memory or stored in a spill
+	// file at the given offset. Stored chunks are deflated on their own if
+	// --compress-temp is set.
+	struct Segment
+	{
+		Segment(std::vector<char> &&data) :
+			data(std::move(data)),
+			file(nullptr),
+			offset(0),
+			disk_size(0),
+			raw_size(0),
+			next(nullptr)
+		{}
+		Segment(SpillFile *file, size_t offset, size_t disk_size, size_t raw_size) :
+			file(file),
+			offset(offset),
+			disk_size(disk_size),
+			raw_size(raw_size),
+			next(nullptr)
+		{}
+		std::vector<char> data;
+		SpillFile *file;
+		size_t offset, disk_size, raw_size;
+		Segment *next;
+	};
+
+	bool reserve(size_t size)
+	{
+		if (mem_size_.fetch_add(size) + size <= mem_limit_)
+			return true;
+		mem_size_ -= size;
+		return false;
+	}
+
+	void push_segment(unsigned bin, Segment *s)
+	{
+		s->next = head_[bin].load(std::memory_order_relaxed);
+		while (!head_[bin].compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void spill(unsigned bin, const std::vector<char> &data, SpillFile &f)
+	{
+		const char *ptr = data.data();
+		size_t size = data.size();
+		std::vector<char> compressed;
+		if (config.compress_temp != 0) {
+			uLongf n = compressBound((uLong)data.size());
+			compressed.resize(n);
+			if (compress2((Bytef*)compressed.data(), &n, (const Bytef*)data.data(), (uLong)data.size(), Z_BEST_SPEED) != Z_OK)
+				throw std::runtime_error("Error compressing temporary file data.");
+			ptr = compressed.data();
+			size = n;
+		}
+		f.file->write(ptr, size);
+		++f.refs;
+		push_segment(bin, new Segment(&f, f.size, size, data.size()));
+		f.size += size;
+	}
+
+	// Reads a stored segment into its data vector.
+	void read_segment(Segment &s)
+	{
+		SpillFile &f = *s.file;
+		if (f.in == nullptr)
+			f.in = new InputFile(*f.file);
+		std::vector<char> buf(s.disk_size);
+		f.in->seek(s.offset);
+		if (f.in->read_raw(buf.data(), s.disk_size) != s.disk_size)
+			throw std::runtime_error("Unexpected end of temporary file: " + f.in->file_name);
+		if (config.compress_temp != 0) {
+			s.data.resize(s.raw_size);
+			uLongf n = (uLongf)s.raw_size;
+			if (uncompress((Bytef*)s.data.data(), &n, (const Bytef*)buf.data(), (uLong)buf.size()) != Z_OK || n != s.raw_size)
+				throw std::runtime_error("Error decompressing temporary file: " + f.in->file_name);
+		}
+		else
+			s.data.swap(buf);
+		total_disk_size_ += s.disk_size;
+	}
+
+	static void delete_segments(Segment *s)
+	{
+		while (s != nullptr) {
+			Segment *next = s->next;
+			if (s->file)
+				release(s->file);
+			delete s;
+			s = next;
+		}
+	}
+
+	size_t raw_disk_size_bin(size_t bin)
+	{
+		size_t raw_size = 0;
+		for (Segment *s = head_[bin].load(std::memory_order_acquire); s != nullptr; s = s->next)
+			if (s->file != nullptr)
+				raw_size += s->raw_size;
+		return raw_size;
+	}
+
 	void load_bin(std::vector<_t> &out, size_t bin)
 	{
-		InputFile f(tmp_file_[bin], InputStreamBuffer::ASYNC);
+		// The list is in reverse order of insertion, restore the original order.
+		Segment *s = head_[bin].exchange(nullptr, std::memory_order_acquire), *list = nullptr;
+		while (s != nullptr) {
+			Segment *next = s->next;
+			s->next = list;
+			list = s;
+			s = next;
+		}
+
 		auto it = std::back_inserter(out);
 		size_t count = 0;
 		try {
-			while(true) count += _t::read(f, it);
-		} catch(EndOfStream&) {}
-		f.close_and_delete();
+			for (s = list; s != nullptr; s = s->next) {
+				if (s->file != nullptr)
+					read_segment(*s);
+				else
+					mem_size_ -= s->data.capacity();
+				Deserializer d(s->data.data(), s->data.data() + s->data.size());
+				try {
+					while (true) count += _t::read(d, it);
+				} catch (EndOfStream&) {}
+				std::vector<char>().swap(s->data);
+			}
+		}
+		catch (...) {
+			delete_segments(list);
+			throw;
+		}
+		delete_segments(list);
 		if (count != count_[bin])
-			throw std::runtime_error("Mismatching hit count / possibly corrupted temporary file: " + f.file_name);
+			throw std::runtime_error("Mismatching hit count / possibly corrupted temporary file.");
 	}
 
 	const unsigned bins_;
-	const size_t bin_size_, input_count_;
-	size_t bins_processed_, total_disk_size_;
-	PtrVector<AsyncFile> tmp_file_;
+	const size_t bin_size_, input_count_, mem_limit_;
+	size_t bins_processed_, total_disk_size_, total_raw_disk_size_;
+	std::atomic_size_t mem_size_;
 	std::atomic_size_t *count_;
+	std::atomic<Segment*> *head_;
 	std::pair<size_t, size_t> input_range_next_;
 	std::vector<_t>* data_next_;
 	std::thread* load_worker_;
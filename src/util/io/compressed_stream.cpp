@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****/
 
 #include <stdexcept>
+#include <algorithm>
 #include "compressed_stream.h"
 
 void ZlibSource::init()
@@ -78,13 +79,14 @@ void ZlibSource::rewind()
 	init();
 }
 
-ZlibSink::ZlibSink(StreamEntity *prev):
-	StreamEntity(prev)
+ZlibSink::ZlibSink(StreamEntity *prev, int level):
+	StreamEntity(prev),
+	total_out_(0)
 {
 	strm.zalloc = Z_NULL;
 	strm.zfree = Z_NULL;
 	strm.opaque = Z_NULL;
-	if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	if (deflateInit2(&strm, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
 		throw std::runtime_error("deflateInit error");
 }
 
@@ -100,6 +102,7 @@ void ZlibSink::deflate_loop(const char *ptr, size_t count, int flush)
 		if (deflate(&strm, flush) == Z_STREAM_ERROR)
 			throw std::runtime_error("deflate error");
 		prev_->flush(chunk_size - strm.avail_out);
+		total_out_ += chunk_size - strm.avail_out;
 	} while (strm.avail_out == 0);
 }
 
@@ -113,4 +116,168 @@ void ZlibSink::close()
 	deflate_loop(0, 0, Z_FINISH);
 	deflateEnd(&strm);
 	prev_->close();
+}
+
+// Finishes the current gzip member so that the data written so far can be
+// read back from the start of the file.
+void ZlibSink::rewind()
+{
+	deflate_loop(0, 0, Z_FINISH);
+	deflateReset(&strm);
+	prev_->rewind();
+}
+
+// Returns the number of compressed bytes written so far. Input still
+// pending in the deflate state is not included.
+size_t ZlibSink::tell()
+{
+	return total_out_;
+}
+
+ZlibSink::~ZlibSink()
+{
+	deflateEnd(&strm);
+}
+
+ParallelZlibSink::ParallelZlibSink(StreamEntity *prev, size_t threads):
+	StreamEntity(prev),
+	next_in_(0),
+	next_out_(0),
+	max_pending_(2 * threads),
+	stop_(false)
+{
+	block_.reserve(block_size);
+	for (size_t i = 0; i < threads; ++i)
+		threads_.emplace_back(&ParallelZlibSink::worker, this);
+}
+
+ParallelZlibSink::~ParallelZlibSink()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		stop_ = true;
+	}
+	work_cv_.notify_all();
+	for (std::thread &t : threads_)
+		if (t.joinable())
+			t.join();
+}
+
+void ParallelZlibSink::compress(const std::vector<char> &in, std::vector<char> &out)
+{
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw std::runtime_error("deflateInit error");
+	out.resize(deflateBound(&strm, (uLong)in.size()) + 32);
+	strm.avail_in = (uInt)in.size();
+	strm.next_in = (Bytef*)in.data();
+	strm.avail_out = (uInt)out.size();
+	strm.next_out = (Bytef*)out.data();
+	const int ret = deflate(&strm, Z_FINISH);
+	deflateEnd(&strm);
+	if (ret != Z_STREAM_END)
+		throw std::runtime_error("deflate error");
+	out.resize(out.size() - strm.avail_out);
+}
+
+void ParallelZlibSink::write_out(const std::vector<char> &data)
+{
+	const char *ptr = data.data(), *end = data.data() + data.size();
+	while (ptr < end) {
+		pair<char*, char*> out = prev_->write_buffer();
+		const size_t n = std::min((size_t)(out.second - out.first), (size_t)(end - ptr));
+		std::copy(ptr, ptr + n, out.first);
+		prev_->flush(n);
+		ptr += n;
+	}
+}
+
+void ParallelZlibSink::worker()
+{
+	std::vector<char> out;
+	while (true) {
+		std::pair<size_t, std::vector<char>> job;
+		{
+			std::unique_lock<std::mutex> lock(mtx_);
+			work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+			if (queue_.empty())
+				return;
+			job = std::move(queue_.front());
+			queue_.pop_front();
+		}
+		try {
+			compress(job.second, out);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(mtx_);
+			error_ = std::current_exception();
+			out.clear();
+		}
+		std::lock_guard<std::mutex> write_lock(write_mtx_);
+		std::unique_lock<std::mutex> lock(mtx_);
+		done_[job.first].swap(out);
+		while (!done_.empty() && done_.begin()->first == next_out_) {
+			std::vector<char> data;
+			data.swap(done_.begin()->second);
+			done_.erase(done_.begin());
+			lock.unlock();
+			try {
+				write_out(data);
+			}
+			catch (...) {
+				lock.lock();
+				error_ = std::current_exception();
+				lock.unlock();
+			}
+			lock.lock();
+			++next_out_;
+		}
+		lock.unlock();
+		space_cv_.notify_all();
+	}
+}
+
+void ParallelZlibSink::submit()
+{
+	std::unique_lock<std::mutex> lock(mtx_);
+	space_cv_.wait(lock, [this] { return next_in_ - next_out_ < max_pending_; });
+	if (error_)
+		std::rethrow_exception(error_);
+	queue_.emplace_back(next_in_++, std::move(block_));
+	lock.unlock();
+	work_cv_.notify_one();
+	block_ = std::vector<char>();
+	block_.reserve(block_size);
+}
+
+void ParallelZlibSink::write(const char *ptr, size_t count)
+{
+	const char *end = ptr + count;
+	while (ptr < end) {
+		const size_t n = std::min(block_size - block_.size(), (size_t)(end - ptr));
+		block_.insert(block_.end(), ptr, ptr + n);
+		ptr += n;
+		if (block_.size() == block_size)
+			submit();
+	}
+}
+
+void ParallelZlibSink::close()
+{
+	if (!block_.empty())
+		submit();
+	{
+		std::unique_lock<std::mutex> lock(mtx_);
+		space_cv_.wait(lock, [this] { return next_out_ == next_in_; });
+		stop_ = true;
+	}
+	work_cv_.notify_all();
+	for (std::thread &t : threads_)
+		t.join();
+	if (error_)
+		std::rethrow_exception(error_);
+	prev_->close();
 }
\ No newline at end of file
@@ -20,6 +20,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define COMPRESSED_STREAM_H_
 
 #include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <zlib.h>
 #include "stream_entity.h"
 #include "../util.h"
@@ -41,13 +48,43 @@ private:
 
 struct ZlibSink : public StreamEntity
 {
-	ZlibSink(StreamEntity *prev);
+	ZlibSink(StreamEntity *prev, int level = Z_DEFAULT_COMPRESSION);
 	virtual void close();
 	virtual void write(const char *ptr, size_t count);
+	virtual void rewind();
+	virtual size_t tell();
+	virtual ~ZlibSink();
 private:
 	void deflate_loop(const char *ptr, size_t count, int code);
 	static const size_t chunk_size = 1llu << 20;
 	z_stream strm;
+	size_t total_out_;
+};
+
+// Splits the stream into blocks that are compressed as independent gzip
+// members by a pool of threads and written in the original order. The
+// output is a valid multi-member gzip file.
+struct ParallelZlibSink : public StreamEntity
+{
+	ParallelZlibSink(StreamEntity *prev, size_t threads);
+	virtual void close();
+	virtual void write(const char *ptr, size_t count);
+	virtual ~ParallelZlibSink();
+private:
+	void submit();
+	void worker();
+	void compress(const std::vector<char> &in, std::vector<char> &out);
+	void write_out(const std::vector<char> &data);
+	static const size_t block_size = 1llu << 20;
+	std::vector<char> block_;
+	std::deque<std::pair<size_t, std::vector<char>>> queue_;
+	std::map<size_t, std::vector<char>> done_;
+	size_t next_in_, next_out_, max_pending_;
+	bool stop_;
+	std::exception_ptr error_;
+	std::mutex mtx_, write_mtx_;
+	std::condition_variable work_cv_, space_cv_;
+	std::vector<std::thread> threads_;
 };
 
 #endif
\ No newline at end of file
@@ -133,6 +133,32 @@ struct Deserializer
 		return *this;
 	}
 
+	// Reads a value written by write_varint64. If the whole encoding fits into
+	// the buffer, it is decoded in place without per-byte bounds checks.
+	void read_varint64(uint64_t &x)
+	{
+		if (avail() >= 10) {
+			const uint8_t *p = (const uint8_t*)begin_;
+			uint64_t r = *p & 0x7f;
+			int shift = 7;
+			while (*p++ & 0x80) {
+				r |= uint64_t(*p & 0x7f) << shift;
+				shift += 7;
+			}
+			begin_ = (const char*)p;
+			x = r;
+			return;
+		}
+		uint8_t b;
+		x = 0;
+		int shift = 0;
+		do {
+			read(b);
+			x |= uint64_t(b & 0x7f) << shift;
+			shift += 7;
+		} while (b & 0x80);
+	}
+
 	template<typename _t>
 	void read(_t &x)
 	{
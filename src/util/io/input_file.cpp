@@ -68,7 +68,7 @@ InputFile::InputFile(const string &file_name, int flags) :
 		source->putback(b[0]);*/
 	buffer_->putback(b, n);
 	if (n == 2 && is_gzip_stream((const unsigned char*)b))
-		buffer_ = new InputStreamBuffer(new ZlibSource(buffer_));
+		buffer_ = new InputStreamBuffer(new ZlibSource(buffer_), InputStreamBuffer::ASYNC);
 }
 
 InputFile::InputFile(TempFile &tmp_file, int flags) :
@@ -77,6 +77,8 @@ InputFile::InputFile(TempFile &tmp_file, int flags) :
 	unlinked(tmp_file.unlinked)
 {
 	tmp_file.rewind();
+	if (tmp_file.compressed)
+		buffer_ = new InputStreamBuffer(new ZlibSource(buffer_), flags);
 }
 
 void InputFile::close_and_delete()
@@ -41,22 +41,34 @@ InputStreamBuffer::InputStreamBuffer(StreamEntity* prev, int flags) :
 
 void InputStreamBuffer::rewind()
 {
+	discard_load();
 	prev_->rewind();
 	file_offset_ = 0;
 }
 
 void InputStreamBuffer::seek(size_t pos)
 {
+	discard_load();
 	prev_->seek(pos);
 	file_offset_ = 0;
 }
 
 void InputStreamBuffer::seek_forward(size_t n)
 {
+	discard_load();
 	prev_->seek_forward(n);
 	file_offset_ = 0;
 }
 
+void InputStreamBuffer::discard_load()
+{
+	if (load_worker_) {
+		load_worker_->join();
+		delete load_worker_;
+		load_worker_ = nullptr;
+	}
+}
+
 pair<const char*, const char*> InputStreamBuffer::read()
 {
 	size_t n;
@@ -69,6 +81,11 @@ pair<const char*, const char*> InputStreamBuffer::read()
 			load_worker_->join();
 			delete load_worker_;
 			load_worker_ = nullptr;
+			if (load_error_) {
+				std::exception_ptr e = load_error_;
+				load_error_ = nullptr;
+				std::rethrow_exception(e);
+			}
 			std::swap(buf_, load_buf_);
 			n = load_count_;
 		}
@@ -84,7 +101,13 @@ pair<const char*, const char*> InputStreamBuffer::read()
 }
 
 void InputStreamBuffer::load_worker(InputStreamBuffer* buf) {
-	buf->load_count_ = buf->prev_->read(buf->load_buf_.get(), config.file_buffer_size);
+	try {
+		buf->load_count_ = buf->prev_->read(buf->load_buf_.get(), config.file_buffer_size);
+	}
+	catch (...) {
+		buf->load_count_ = 0;
+		buf->load_error_ = std::current_exception();
+	}
 }
 
 void InputStreamBuffer::putback(const char* p, size_t n) {
@@ -93,11 +116,7 @@ void InputStreamBuffer::putback(const char* p, size_t n) {
 }
 
 void InputStreamBuffer::close() {
-	if (load_worker_) {
-		load_worker_->join();
-		delete load_worker_;
-		load_worker_ = nullptr;
-	}
+	discard_load();
 	prev_->close();
 }
 
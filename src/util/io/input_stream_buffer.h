@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <utility>
 #include <memory>
 #include <thread>
+#include <exception>
 #include "stream_entity.h"
 
 struct InputStreamBuffer : public StreamEntity
@@ -39,9 +40,11 @@ struct InputStreamBuffer : public StreamEntity
 private:
 
 	static void load_worker(InputStreamBuffer *buf);
+	void discard_load();
 	
 	std::unique_ptr<char[]> buf_, load_buf_;
 	size_t putback_count_, load_count_, file_offset_;
 	bool async_;
 	std::thread* load_worker_;
+	std::exception_ptr load_error_;
 };
\ No newline at end of file
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <stdio.h>
+#include "../../basic/config.h"
 #include "output_file.h"
 #include "file_sink.h"
 #include "output_stream_buffer.h"
@@ -31,7 +32,10 @@ OutputFile::OutputFile(const string &file_name, bool compressed, const char *mod
 	file_name_(file_name)
 {
 	if (compressed) {
-		buffer_ = new OutputStreamBuffer(new ZlibSink(buffer_));
+		if (config.threads_ > 1)
+			buffer_ = new OutputStreamBuffer(new ParallelZlibSink(buffer_, config.threads_));
+		else
+			buffer_ = new OutputStreamBuffer(new ZlibSink(buffer_));
 		reset_buffer();
 	}
 }
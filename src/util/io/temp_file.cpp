@@ -33,6 +33,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../../basic/config.h"
 #include "../util.h"
 #include "input_file.h"
+#include "output_stream_buffer.h"
+#include "compressed_stream.h"
 
 using std::vector;
 using std::string;
@@ -78,18 +80,31 @@ pair<string, int> TempFile::init(bool unlink)
 #endif
 }
 
-TempFile::TempFile(bool unlink):
+TempFile::TempFile(bool unlink, bool compressed):
 #ifdef _MSC_VER
-	OutputFile(init(unlink), false, "w+b")
+	OutputFile(init(unlink), false, "w+b"),
 #else
-	OutputFile(init(unlink), "w+b")
+	OutputFile(init(unlink), "w+b"),
 #endif
+	compressed(compressed)
 {
+	init_compression();
 }
 
-TempFile::TempFile(const std::string & file_name):
-	OutputFile(file_name)
+TempFile::TempFile(const std::string & file_name, bool compressed):
+	OutputFile(file_name),
+	unlinked(false),
+	compressed(compressed)
 {
+	init_compression();
+}
+
+void TempFile::init_compression()
+{
+	if (!compressed)
+		return;
+	buffer_ = new OutputStreamBuffer(new ZlibSink(buffer_, Z_BEST_SPEED));
+	reset_buffer();
 }
 
 string TempFile::get_temp_dir()
@@ -25,16 +25,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 struct TempFile : public OutputFile
 {
 
-	TempFile(bool unlink = true);
-	TempFile(const std::string & file_name);
+	// If compressed is set, the file is written as a fast gzip stream that
+	// InputFile(TempFile&) decompresses transparently.
+	TempFile(bool unlink = true, bool compressed = false);
+	TempFile(const std::string & file_name, bool compressed = false);
 	virtual void finalize() override {}
 	static std::string get_temp_dir();
 	static unsigned n;
 	static uint64_t hash_key;
-	bool unlinked;
+	bool unlinked, compressed;
 
 private:
 
+	void init_compression();
+
 #ifdef _MSC_VER
 	std::string init(bool unlink);
 #else
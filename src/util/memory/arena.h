@@ -0,0 +1,168 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Util { namespace Memory {
+
+// Monotonic memory for short-lived node based containers. Memory is handed
+// out from large chunks and only reclaimed as a whole by reset(). A thread
+// makes an arena current by holding an Arena::Scope.
+struct Arena {
+
+	enum { ALIGN = alignof(std::max_align_t) };
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 1llu << 20, MAX_RETAINED_SIZE = 1llu << 28;
+
+	struct Scope {
+		Scope(Arena &arena) :
+			prev_(current())
+		{
+			current() = &arena;
+		}
+		~Scope()
+		{
+			current() = prev_;
+		}
+	private:
+		Arena *prev_;
+	};
+
+	Arena() :
+		chunk_size_(DEFAULT_CHUNK_SIZE),
+		size_(0),
+		ptr_(nullptr),
+		end_(nullptr)
+	{}
+
+	~Arena()
+	{
+		release();
+	}
+
+	void* allocate(size_t n)
+	{
+		n = (n + ALIGN - 1) & ~size_t(ALIGN - 1);
+		if (size_t(end_ - ptr_) < n)
+			new_chunk(n);
+		void *p = ptr_;
+		ptr_ += n;
+		return p;
+	}
+
+	// Invalidates all previous allocations. If more than one chunk was
+	// needed, they are replaced by a single chunk of the combined size.
+	void reset()
+	{
+		if (chunks_.size() > 1 || size_ > MAX_RETAINED_SIZE) {
+			const size_t size = size_;
+			release();
+			chunk_size_ = size > MAX_RETAINED_SIZE ? DEFAULT_CHUNK_SIZE : size;
+		}
+		if (!chunks_.empty()) {
+			ptr_ = chunks_.front().first;
+			end_ = ptr_ + chunks_.front().second;
+		}
+	}
+
+	static Arena*& current()
+	{
+		static thread_local Arena *arena = nullptr;
+		return arena;
+	}
+
+private:
+
+	void new_chunk(size_t n)
+	{
+		const size_t size = std::max(n, chunk_size_);
+		ptr_ = new char[size];
+		end_ = ptr_ + size;
+		chunks_.emplace_back(ptr_, size);
+		size_ += size;
+		chunk_size_ = std::min(chunk_size_ * 2, MAX_RETAINED_SIZE);
+	}
+
+	void release()
+	{
+		for (const std::pair<char*, size_t> &c : chunks_)
+			delete[] c.first;
+		chunks_.clear();
+		size_ = 0;
+		ptr_ = end_ = nullptr;
+	}
+
+	std::vector<std::pair<char*, size_t>> chunks_;
+	size_t chunk_size_, size_;
+	char *ptr_, *end_;
+
+};
+
+// Allocates from the arena that is current on the calling thread, or from the
+// heap if there is none. Each block records its origin, so containers may
+// exchange nodes (e.g. by splice) regardless of which thread created them.
+// Arena blocks must not outlive the next reset() of their arena.
+template<typename T>
+struct ArenaAllocator {
+
+	typedef T value_type;
+
+	ArenaAllocator()
+	{}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>&)
+	{}
+
+	T* allocate(size_t n)
+	{
+		Arena *arena = Arena::current();
+		const size_t size = n * sizeof(T) + Arena::ALIGN;
+		char *p = arena ? (char*)arena->allocate(size) : (char*)::operator new(size);
+		*(Arena**)p = arena;
+		return (T*)(p + Arena::ALIGN);
+	}
+
+	void deallocate(T* p, size_t)
+	{
+		char *q = (char*)p - Arena::ALIGN;
+		if (*(Arena**)q == nullptr)
+			::operator delete(q);
+	}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U>&) const
+	{
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U>&) const
+	{
+		return false;
+	}
+
+};
+
+}}
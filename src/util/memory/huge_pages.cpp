@@ -0,0 +1,143 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <fstream>
+#include <new>
+#include <string>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#include "huge_pages.h"
+#include "../log_stream.h"
+
+using std::endl;
+
+namespace Util { namespace Memory {
+
+bool huge_pages = false;
+
+// Every block starts with a header that records how it was allocated.
+struct Header {
+	size_t size;
+	int mode;
+};
+
+enum { HEADER_SIZE = 64, MALLOC = 0, HUGETLB = 1, TRANSPARENT = 2 };
+
+static std::atomic<size_t> requested_bytes(0), hugetlb_bytes(0), transparent_peak(0);
+
+#ifdef __linux__
+
+// Returns the process-wide amount of anonymous memory in transparent huge pages.
+static size_t anon_huge_pages()
+{
+	std::ifstream in("/proc/self/smaps_rollup");
+	std::string key;
+	size_t kb;
+	while (in >> key) {
+		if (key == "AnonHugePages:" && in >> kb)
+			return kb * 1024;
+		in.ignore(256, '\n');
+	}
+	return 0;
+}
+
+static void sample_transparent()
+{
+	const size_t n = anon_huge_pages();
+	size_t peak = transparent_peak;
+	while (n > peak && !transparent_peak.compare_exchange_weak(peak, n));
+}
+
+// Maps an aligned region so that it can be covered by huge pages entirely.
+static char* map_aligned(size_t size)
+{
+	void *p = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		throw std::bad_alloc();
+	char *begin = (char*)p, *aligned = (char*)(((uintptr_t)begin + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+	if (aligned > begin)
+		munmap(begin, aligned - begin);
+	munmap(aligned + size, begin + HUGE_PAGE_SIZE - aligned);
+	return aligned;
+}
+
+#endif
+
+void* huge_page_alloc(size_t n)
+{
+	Header *h;
+#ifdef __linux__
+	if (huge_pages && n >= HUGE_PAGE_SIZE) {
+		const size_t size = (n + HEADER_SIZE + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+		void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p != MAP_FAILED) {
+			h = (Header*)p;
+			h->mode = HUGETLB;
+			hugetlb_bytes += size;
+		}
+		else {
+			h = (Header*)map_aligned(size);
+			madvise(h, size, MADV_HUGEPAGE);
+			h->mode = TRANSPARENT;
+		}
+		h->size = size;
+		requested_bytes += size;
+		return (char*)h + HEADER_SIZE;
+	}
+#endif
+	h = (Header*)malloc(n + HEADER_SIZE);
+	if (h == nullptr)
+		throw std::bad_alloc();
+	h->mode = MALLOC;
+	return (char*)h + HEADER_SIZE;
+}
+
+void huge_page_free(void *p)
+{
+	if (p == nullptr)
+		return;
+	Header *h = (Header*)((char*)p - HEADER_SIZE);
+#ifdef __linux__
+	if (h->mode != MALLOC) {
+		if (h->mode == TRANSPARENT)
+			sample_transparent();
+		munmap(h, h->size);
+		return;
+	}
+#endif
+	free(h);
+}
+
+void log_huge_page_stats()
+{
+	if (!huge_pages)
+		return;
+#ifdef __linux__
+	sample_transparent();
+#endif
+	verbose_stream << "Huge page allocations: " << requested_bytes / 1e9 << " GB, hugetlbfs: " << hugetlb_bytes / 1e9
+		<< " GB, transparent huge pages (peak): " << transparent_peak / 1e9 << " GB" << endl;
+}
+
+}}
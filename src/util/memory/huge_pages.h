@@ -0,0 +1,70 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#pragma once
+#include <cstddef>
+
+namespace Util { namespace Memory {
+
+// Allocations of at least HUGE_PAGE_SIZE bytes are backed by huge pages if
+// enabled (option --huge-pages). Memory is taken from the hugetlbfs pool if
+// pages are reserved there, otherwise transparent huge pages are requested
+// with madvise. Smaller allocations and systems without huge page support
+// fall back to malloc.
+enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 };
+
+extern bool huge_pages;
+
+void* huge_page_alloc(size_t n);
+void huge_page_free(void *p);
+// Logs the amount of memory requested and actually backed by huge pages.
+void log_huge_page_stats();
+
+template<typename T>
+struct HugePageAllocator {
+
+	typedef T value_type;
+
+	HugePageAllocator() noexcept {}
+
+	template<typename T2>
+	HugePageAllocator(const HugePageAllocator<T2>&) noexcept {}
+
+	T* allocate(size_t n) {
+		return (T*)huge_page_alloc(n * sizeof(T));
+	}
+
+	void deallocate(T *p, size_t) {
+		huge_page_free(p);
+	}
+
+	template<typename T2>
+	bool operator==(const HugePageAllocator<T2>&) const {
+		return true;
+	}
+
+	template<typename T2>
+	bool operator!=(const HugePageAllocator<T2>&) const {
+		return false;
+	}
+
+};
+
+}}
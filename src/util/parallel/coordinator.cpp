@@ -0,0 +1,413 @@
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstring>
+#ifndef WIN32
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+// #define DEBUG
+#undef DEBUG
+#include "filestack.h"
+#include "coordinator.h"
+
+using namespace std;
+
+// Requests and replies are single lines. A request consists of the operation,
+// the stack name, which is the absolute path of the stack file, and an
+// optional argument, separated by tabs:
+//   SIZE name                  -> size
+//   POP name / TOP name        -> found \t size_after \t line
+//   PUSH name line             -> size_after
+//   CLEAR name                 -> 0
+//   WAITTOP name timeout query -> 1 (found), STOP or 0 (timed out)
+//   WAITSIZE name timeout size -> 1 (reached) or 0 (timed out)
+
+#ifdef WIN32
+
+namespace Coordinator {
+
+void run(const string & address) {
+    throw(runtime_error("The coordinator is not supported on Windows."));
+}
+
+}
+
+RemoteStack::RemoteStack(const string & address, const string & name) : address(address), name(name) {
+    throw(runtime_error("The coordinator is not supported on Windows."));
+}
+
+size_t RemoteStack::size() { return 0; }
+int RemoteStack::pop(string & buf, const bool keep_flag, size_t & size_after_pop) { return 0; }
+int RemoteStack::push(const string & buf, size_t & size_after_push) { return 0; }
+int RemoteStack::clear() { return 0; }
+bool RemoteStack::poll_query(const string & query, const double sleep_s, const size_t max_iter) { return false; }
+bool RemoteStack::poll_size(const size_t size, const double sleep_s, const size_t max_iter) { return false; }
+
+#else
+
+static bool is_unix_socket(const string & address) {
+    return address.find('/') != string::npos;
+}
+
+static int open_socket(const string & address, const bool server) {
+    int fd = -1;
+    if (is_unix_socket(address)) {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(addr.sun_path)) {
+            throw(runtime_error("socket path is too long: " + address));
+        }
+        strcpy(addr.sun_path, address.c_str());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw(runtime_error("could not create socket"));
+        }
+        if (server) {
+            unlink(address.c_str());
+            if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+                throw(runtime_error("could not listen on " + address + ": " + strerror(errno)));
+            }
+        } else if (connect(fd, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+            throw(runtime_error("could not connect to coordinator " + address + ": " + strerror(errno)));
+        }
+        return fd;
+    }
+
+    const size_t colon = address.rfind(':');
+    if (colon == string::npos) {
+        throw(runtime_error("invalid coordinator address " + address + " (expected host:port or a socket path)"));
+    }
+    const string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (server) {
+        hints.ai_flags = AI_PASSIVE;
+    }
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res) != 0) {
+        throw(runtime_error("could not resolve coordinator address " + address));
+    }
+    for (addrinfo *p = res; p != nullptr; p = p->ai_next) {
+        fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        if (server) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, p->ai_addr, p->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+                break;
+            }
+        } else if (connect(fd, p->ai_addr, p->ai_addrlen) == 0) {
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        throw(runtime_error(string(server ? "could not listen on " : "could not connect to coordinator ") + address + ": " + strerror(errno)));
+    }
+    return fd;
+}
+
+// Buffered line reader and writer for a socket.
+struct Connection {
+    Connection(int fd) : fd(fd) {}
+
+    ~Connection() {
+        close(fd);
+    }
+
+    bool read_line(string & line) {
+        for (;;) {
+            const size_t i = buf.find('\n');
+            if (i != string::npos) {
+                line.assign(buf, 0, i);
+                buf.erase(0, i + 1);
+                return true;
+            }
+            char raw[4096];
+            const ssize_t n = ::read(fd, raw, sizeof(raw));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            buf.append(raw, n);
+        }
+    }
+
+    bool write_line(const string & line) {
+        const string msg = line + '\n';
+        const char *ptr = msg.data();
+        size_t n = msg.size();
+        while (n > 0) {
+            const ssize_t w = ::write(fd, ptr, n);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            ptr += w;
+            n -= (size_t)w;
+        }
+        return true;
+    }
+
+    const int fd;
+    string buf;
+    mutex mtx;
+};
+
+namespace Coordinator {
+
+struct Server {
+
+    // Stacks are initialized from their file on first use, so that stacks
+    // prepared by --mp-init (e.g. the reference partitions) are picked up.
+    // A stack that is first read rather than written is a work stack, whose
+    // file must exist; nullptr is returned if it does not.
+    vector<string> * get(const string & name, bool read) {
+        auto it = stacks.find(name);
+        if (it != stacks.end()) {
+            return &it->second;
+        }
+        ifstream in(name);
+        if (read && !in) {
+            return nullptr;
+        }
+        vector<string> & s = stacks[name];
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty()) {
+                s.push_back(line);
+            }
+        }
+        return &s;
+    }
+
+    string handle(const string & request) {
+        const size_t i = request.find('\t');
+        if (i == string::npos) {
+            return "ERR\tmalformed request";
+        }
+        const size_t j = request.find('\t', i + 1);
+        const string op = request.substr(0, i),
+            name = request.substr(i + 1, j == string::npos ? string::npos : j - i - 1),
+            arg = j == string::npos ? string() : request.substr(j + 1);
+        DBG(op + " " + name + " " + arg);
+
+        if (name.empty() || name[0] != '/') {
+            return "ERR\tstack name is not an absolute path: " + name;
+        }
+        unique_lock<mutex> lock(mtx);
+        vector<string> * stack = get(name, op == "POP" || op == "TOP");
+        if (stack == nullptr) {
+            return "ERR\tstack file not found: " + name;
+        }
+        vector<string> & s = *stack;
+        if (op == "SIZE") {
+            return to_string(s.size());
+        } else if (op == "POP" || op == "TOP") {
+            if (s.empty()) {
+                return "0\t0\t";
+            }
+            const string line = s.back();
+            if (op == "POP") {
+                s.pop_back();
+                changed.notify_all();
+            }
+            return "1\t" + to_string(s.size()) + '\t' + line;
+        } else if (op == "PUSH") {
+            if (!arg.empty()) {
+                s.push_back(arg);
+            }
+            changed.notify_all();
+            return to_string(s.size());
+        } else if (op == "CLEAR") {
+            s.clear();
+            changed.notify_all();
+            return "0";
+        } else if (op == "WAITTOP" || op == "WAITSIZE") {
+            const size_t k = arg.find('\t');
+            if (k == string::npos) {
+                return "ERR\tmalformed request";
+            }
+            const auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(stod(arg.substr(0, k))));
+            const string value = arg.substr(k + 1);
+            if (op == "WAITTOP") {
+                const auto stop = [&s]() { return !s.empty() && s.back().find("STOP") != string::npos; };
+                const auto found = [&s, &value]() { return !s.empty() && s.back().find(value) != string::npos; };
+                changed.wait_until(lock, deadline, [&]() { return found() || stop(); });
+                return found() ? "1" : (stop() ? "STOP" : "0");
+            } else {
+                const size_t n = stoull(value);
+                return changed.wait_until(lock, deadline, [&s, n]() { return s.size() == n; }) ? "1" : "0";
+            }
+        }
+        return "ERR\tunknown operation " + op;
+    }
+
+    mutex mtx;
+    condition_variable changed;
+    unordered_map<string, vector<string>> stacks;
+
+};
+
+static void serve_connection(Server *server, int fd) {
+    Connection conn(fd);
+    string request;
+    while (conn.read_line(request)) {
+        string reply;
+        try {
+            reply = server->handle(request);
+        }
+        catch (exception & e) {
+            reply = string("ERR\t") + e.what();
+        }
+        if (!conn.write_line(reply)) {
+            break;
+        }
+    }
+}
+
+void run(const string & address) {
+    Server server;
+    const int listen_fd = open_socket(address, true);
+    signal(SIGPIPE, SIG_IGN);
+    cerr << "Coordinator listening on " << address << endl;
+    for (;;) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            throw(runtime_error(string("error accepting connection: ") + strerror(errno)));
+        }
+        if (!is_unix_socket(address)) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        thread(serve_connection, &server, fd).detach();
+    }
+}
+
+}
+
+static Connection & connection(const string & address) {
+    static mutex mtx;
+    static unordered_map<string, unique_ptr<Connection>> connections;
+    lock_guard<mutex> lock(mtx);
+    unique_ptr<Connection> & conn = connections[address];
+    if (!conn) {
+        conn.reset(new Connection(open_socket(address, false)));
+    }
+    return *conn;
+}
+
+RemoteStack::RemoteStack(const string & address, const string & name) : address(address), name(name) {
+    connection(address);
+}
+
+string RemoteStack::request(const string & op, const string & arg) {
+    Connection & conn = connection(address);
+    lock_guard<mutex> lock(conn.mtx);
+    string reply;
+    if (!conn.write_line(op + '\t' + name + (arg.empty() ? string() : '\t' + arg)) || !conn.read_line(reply)) {
+        throw(runtime_error("lost connection to coordinator " + address));
+    }
+    if (reply.compare(0, 4, "ERR\t") == 0) {
+        throw(runtime_error("coordinator: " + reply.substr(4)));
+    }
+    return reply;
+}
+
+size_t RemoteStack::size() {
+    DBG("");
+    return stoull(request("SIZE"));
+}
+
+int RemoteStack::pop(string & buf, const bool keep_flag, size_t & size_after_pop) {
+    DBG("");
+    const string reply = request(keep_flag ? "TOP" : "POP");
+    const size_t i = reply.find('\t'), j = reply.find('\t', i + 1);
+    buf.assign(reply, j + 1, string::npos);
+    if (size_after_pop != NO_SIZE) {
+        size_after_pop = stoull(reply.substr(i + 1, j - i - 1));
+    }
+    DBG(buf);
+    return buf.size();
+}
+
+// Like in a file, each line of buf becomes a separate entry.
+int RemoteStack::push(const string & buf, size_t & size_after_push) {
+    DBG(buf);
+    size_t n = 0, begin = 0;
+    do {
+        size_t end = buf.find('\n', begin);
+        if (end == string::npos) {
+            end = buf.size();
+        }
+        n = stoull(request("PUSH", buf.substr(begin, end - begin)));
+        begin = end + 1;
+    } while (begin < buf.size());
+    if (size_after_push != NO_SIZE) {
+        size_after_push = n;
+    }
+    return buf.size();
+}
+
+int RemoteStack::clear() {
+    DBG("");
+    request("CLEAR");
+    return 0;
+}
+
+bool RemoteStack::poll_query(const string & query, const double sleep_s, const size_t max_iter) {
+    DBG(query);
+    const double timeout = double(max_iter) * sleep_s;
+    const string reply = request("WAITTOP", to_string(timeout) + '\t' + query);
+    if (reply == "STOP") {
+        throw(runtime_error("STOP on stack " + name));
+    }
+    if (reply != "1") {
+        throw(runtime_error("Could not discover keyword " + query + " on stack " + name
+                          + " within " + to_string(timeout) + " seconds."));
+    }
+    return true;
+}
+
+bool RemoteStack::poll_size(const size_t size, const double sleep_s, const size_t max_iter) {
+    DBG("");
+    const double timeout = double(max_iter) * sleep_s;
+    if (request("WAITSIZE", to_string(timeout) + '\t' + to_string(size)) != "1") {
+        throw(runtime_error("Could not detect size " + to_string(size) + " of stack " + name
+                          + " within " + to_string(timeout) + " seconds."));
+    }
+    return true;
+}
+
+#endif
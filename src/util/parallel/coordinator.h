@@ -0,0 +1,44 @@
+#ifndef _COORDINATOR_H_
+#define _COORDINATOR_H_
+
+#include <string>
+#include "stack.h"
+
+// Coordinator process for multiprocessing runs (option --mp-coordinator).
+// It holds all stacks of a run in memory and serves them to the workers over
+// a Unix socket (address containing a '/') or TCP (host:port). Workers waiting
+// for a stack to change are woken up by the operation that changes it instead
+// of polling. Stacks that are not known to the coordinator yet are initialized
+// from the file of the same name if it exists.
+namespace Coordinator {
+
+void run(const std::string & address);
+
+}
+
+// Stack held by the coordinator. All stacks of a process share one connection.
+class RemoteStack : public Stack {
+    public:
+        RemoteStack(const std::string & address, const std::string & name);
+
+        size_t size() override;
+
+        using Stack::pop;
+        using Stack::push;
+
+        int pop(std::string & buf, const bool keep_flag, size_t & size_after_pop) override;
+        int push(const std::string & buf, size_t & size_after_push) override;
+
+        int clear() override;
+
+        bool poll_query(const std::string & query, const double sleep_s=0.5, const size_t max_iter=7200) override;
+        bool poll_size(const size_t size, const double sleep_s=0.5, const size_t max_iter=7200) override;
+
+    private:
+        std::string request(const std::string & op, const std::string & arg = std::string());
+
+        std::string address;
+        std::string name;
+};
+
+#endif
@@ -145,7 +145,7 @@ int FileStack::pop(string & buf, const bool keep_flag, size_t & size_after_pop)
             }
         }
     }
-    if (size_after_pop != numeric_limits<size_t>::max()) {
+    if (size_after_pop != NO_SIZE) {
         size_after_pop = this->size();
     }
     if (locked_internally) {
@@ -162,27 +162,27 @@ int FileStack::pop(string & buf, const bool keep_flag, size_t & size_after_pop)
 #endif
 }
 
-int FileStack::pop(string & buf) {
+int Stack::pop(string & buf) {
     DBG("");
-    size_t size_after_pop = numeric_limits<size_t>::max();
+    size_t size_after_pop = NO_SIZE;
     return pop(buf, false, size_after_pop);
 }
 
-int FileStack::top(string & buf) {
+int Stack::top(string & buf) {
     DBG("");
-    size_t size_after_pop = numeric_limits<size_t>::max();
+    size_t size_after_pop = NO_SIZE;
     return pop(buf, true, size_after_pop);
 }
 
-int FileStack::pop(string & buf, size_t & size_after_pop) {
+int Stack::pop(string & buf, size_t & size_after_pop) {
     DBG("");
     return pop(buf, false, size_after_pop);
 }
 
-int FileStack::pop(int & i) {
+int Stack::pop(int & i) {
     DBG("");
     string buf;
-    size_t size_after_pop = numeric_limits<size_t>::max();
+    size_t size_after_pop = NO_SIZE;
     const int get_status = pop(buf, false, size_after_pop);
     if (get_status > 0) {
         return i = stoi(buf);
@@ -191,10 +191,10 @@ int FileStack::pop(int & i) {
     }
 }
 
-int FileStack::top(int & i) {
+int Stack::top(int & i) {
     DBG("");
     string buf;
-    size_t size_after_pop = numeric_limits<size_t>::max();
+    size_t size_after_pop = NO_SIZE;
     const int get_status = pop(buf, true, size_after_pop);
     if (get_status > 0) {
         return i = stoi(buf);
@@ -260,7 +260,7 @@ int FileStack::push(const string & buf, size_t & size_after_push) {
         locked_internally = true;
     }
     size_t n = push_non_locked(buf);
-    if (size_after_push != numeric_limits<size_t>::max()) {
+    if (size_after_push != NO_SIZE) {
         size_after_push = size();
     }
     if (locked_internally) {
@@ -269,13 +269,13 @@ int FileStack::push(const string & buf, size_t & size_after_push) {
     return n;
 }
 
-int FileStack::push(const string & buf) {
+int Stack::push(const string & buf) {
     DBG("");
-    size_t size_after_push = numeric_limits<size_t>::max();
+    size_t size_after_push = NO_SIZE;
     return push(buf, size_after_push);
 }
 
-int FileStack::push(int i) {
+int Stack::push(int i) {
     DBG("");
     string buf = to_string(i);
     return push(buf);
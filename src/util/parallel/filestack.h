@@ -2,6 +2,7 @@
 #define _FILESTACK_H_
 
 #include <string>
+#include "stack.h"
 #ifndef WIN32
 #include <unistd.h>
 #include <fcntl.h>
@@ -15,39 +16,35 @@
 #endif
 
 
-class FileStack {
+class FileStack : public Stack {
     public:
         FileStack();
         FileStack(const std::string & file_name);
         FileStack(const std::string & file_name, int maximum_line_length);
         ~FileStack();
 
-        size_t size();
+        size_t size() override;
 
-        int pop(int & i);
-        int pop(std::string & buf);
-        int pop(std::string & buf, size_t & size_after_pop);
+        using Stack::pop;
+        using Stack::push;
 
-        int top(int & i);
-        int top(std::string & buf);
+        int pop(std::string & buf, const bool keep_flag, size_t & size_after_pop) override;
 
         // int remove(const std::string & line);
 
-        int push(int i);
-        int push(const std::string & buf);
-        int push(const std::string & buf, size_t & size_after_push);
+        int push(const std::string & buf, size_t & size_after_push) override;
         int push_non_locked(const std::string & buf);
 
         int get_max_line_length();
         int set_max_line_length(int n);
 
-        int clear();
+        int clear() override;
 
         int lock();
         int unlock();
 
-        bool poll_query(const std::string & query, const double sleep_s=0.5, const size_t max_iter=7200);
-        bool poll_size(const size_t size, const double sleep_s=0.5, const size_t max_iter=7200);
+        bool poll_query(const std::string & query, const double sleep_s=0.5, const size_t max_iter=7200) override;
+        bool poll_size(const size_t size, const double sleep_s=0.5, const size_t max_iter=7200) override;
 
     private:
         int fd;
@@ -57,8 +54,6 @@ class FileStack {
 #endif
         std::string file_name;
         off_t max_line_length;
-
-        int pop(std::string &, const bool, size_t &);
 };
 
 #endif
@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <memory>
 #ifndef WIN32
+#include <limits.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #endif
@@ -14,6 +15,7 @@
 // #define DEBUG
 #undef DEBUG
 #include "filestack.h"
+#include "coordinator.h"
 #include "parallelizer.h"
 
 using namespace std;
@@ -36,8 +38,9 @@ Parallelizer::Parallelizer() : work_directory("parallelizer"), n_registered(0),
 }
 
 
-void Parallelizer::init(const string & tempdir) {
+void Parallelizer::init(const string & tempdir, const string & coordinator) {
     DBG("");
+    coordinator_address = coordinator;
     if (tempdir.size() > 0) {
         work_directory = join_path(tempdir, work_directory);
     }
@@ -66,7 +69,9 @@ void Parallelizer::init(const string & tempdir) {
 #endif
     DBG("id = " + id);
 
-    create_stack(LOG, id);
+    // the log is kept in a file per process in any case
+    log_stack = shared_ptr<FileStack>(new FileStack(join_path(work_directory, LOG + "_" + id)));
+    fs_map.emplace(LOG, log_stack);
     create_stack(COMMAND);
     create_stack(WORKERS);
     create_stack(REGISTER);
@@ -122,28 +127,28 @@ bool Parallelizer::barrier(const string & tag) {
 
     auto cmd_file_name = get_barrier_file_name("cmd", tag, i_barrier);
     DBG(cmd_file_name);
-    auto cmd_fs = FileStack(cmd_file_name);
+    auto cmd_fs = open_stack(cmd_file_name);
     auto ack_file_name = get_barrier_file_name("ack", tag, i_barrier);
     DBG(ack_file_name);
-    auto ack_fs = FileStack(ack_file_name);
+    auto ack_fs = open_stack(ack_file_name);
 
     static const string msg = "WAIT";
     if (is_master()) {
-        ack_fs.clear();
-        cmd_fs.push(msg);
+        ack_fs->clear();
+        cmd_fs->push(msg);
     }
-    cmd_fs.poll_query(msg);
-    ack_fs.push(id);
+    cmd_fs->poll_query(msg);
+    ack_fs->push(id);
 
     DBG(msg);
 
     static const string msg_ok = "GOON";
     if (is_master()) {
         const size_t n_workers = get_stack(WORKERS)->size();
-        ack_fs.poll_size(n_workers);
-        cmd_fs.push(msg_ok);
+        ack_fs->poll_size(n_workers);
+        cmd_fs->push(msg_ok);
     }
-    cmd_fs.poll_query(msg_ok);
+    cmd_fs->poll_query(msg_ok);
 
     DBG(msg_ok);
 
@@ -190,18 +195,43 @@ bool Parallelizer::create_stack(const std::string & tag, std::string sfx) {
 
 bool Parallelizer::create_stack_from_file(const std::string & tag, const std::string & file_name) {
     delete_stack(tag);
-    fs_map.emplace(tag, shared_ptr<FileStack>(new FileStack(file_name)));
+    fs_map.emplace(tag, open_stack(file_name));
     DBG(file_name);
     return true;
 }
 
 
-std::shared_ptr<FileStack> Parallelizer::get_stack(const std::string & tag) {
+std::shared_ptr<Stack> Parallelizer::get_stack(const std::string & tag) {
 	// cerr << __PRETTY_FUNCTION__ << endl;
     return fs_map.at(tag);
 }
 
 
+// The coordinator may run in a different working directory, so remote stacks
+// are named by absolute paths.
+static string absolute_path(const string & file_name) {
+#ifndef WIN32
+    if (!file_name.empty() && file_name[0] != '/') {
+        char cwd[PATH_MAX];
+        if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+            throw(runtime_error("could not determine the working directory"));
+        }
+        return join_path(cwd, file_name);
+    }
+#endif
+    return file_name;
+}
+
+
+std::shared_ptr<Stack> Parallelizer::open_stack(const std::string & file_name) {
+    if (coordinator_address.empty()) {
+        return shared_ptr<Stack>(new FileStack(file_name));
+    } else {
+        return shared_ptr<Stack>(new RemoteStack(coordinator_address, absolute_path(file_name)));
+    }
+}
+
+
 bool Parallelizer::delete_stack(const std::string & tag) {
     if (fs_map.find(tag) != fs_map.end()) {
         fs_map.erase(tag);
@@ -236,8 +266,6 @@ void Parallelizer::list_filestacks() {
 
 
 void Parallelizer::log(const string & buf) {
-	auto log_stack = get_stack(LOG);
-
     // we use ms since the Epoch as the universal timestamp
     const auto ms = chrono::duration_cast<chrono::milliseconds>(
             chrono::system_clock::now() - chrono::time_point<chrono::system_clock>{}
@@ -15,7 +15,9 @@ class Parallelizer {
         Parallelizer();
         ~Parallelizer();
 
-        void init(const std::string & tempdir = std::string());
+        // Stacks are held by the coordinator at the given address if it is not empty,
+        // otherwise they are files in the working directory.
+        void init(const std::string & tempdir = std::string(), const std::string & coordinator = std::string());
         void clear();
 
         int get_rank();
@@ -32,7 +34,8 @@ class Parallelizer {
 
         bool create_stack(const std::string & tag, std::string sfx="");
         bool delete_stack(const std::string & tag);
-        std::shared_ptr<FileStack> get_stack(const std::string & tag);
+        std::shared_ptr<Stack> get_stack(const std::string & tag);
+        std::shared_ptr<Stack> open_stack(const std::string & file_name);
 
         static void sleep(const double sleep_s);
 
@@ -53,6 +56,7 @@ class Parallelizer {
         const std::string BARRIER = "barrier";
         std::string work_directory;
         std::string barrier_file;
+        std::string coordinator_address;
 
         int rank;
         std::string id;
@@ -68,7 +72,8 @@ class Parallelizer {
         std::vector<std::string> continuous_cleanup_list;
         std::vector<std::string> final_cleanup_list;
 
-        std::unordered_map<std::string, std::shared_ptr<FileStack>> fs_map;
+        std::unordered_map<std::string, std::shared_ptr<Stack>> fs_map;
+        std::shared_ptr<FileStack> log_stack;
 };
 
 #endif
@@ -0,0 +1,39 @@
+#ifndef _STACK_H_
+#define _STACK_H_
+
+#include <string>
+#include <limits>
+
+// Line based stack shared between the processes of a multiprocessing run.
+// Stacks are identified by a file name. They are stored in that file (FileStack)
+// or held by a coordinator process (RemoteStack).
+class Stack {
+    public:
+        virtual ~Stack() {}
+
+        virtual size_t size() = 0;
+
+        // size_after is only computed if it is not set to numeric_limits<size_t>::max()
+        virtual int pop(std::string & buf, const bool keep_flag, size_t & size_after_pop) = 0;
+        virtual int push(const std::string & buf, size_t & size_after_push) = 0;
+
+        virtual int clear() = 0;
+
+        virtual bool poll_query(const std::string & query, const double sleep_s=0.5, const size_t max_iter=7200) = 0;
+        virtual bool poll_size(const size_t size, const double sleep_s=0.5, const size_t max_iter=7200) = 0;
+
+        int pop(int & i);
+        int pop(std::string & buf);
+        int pop(std::string & buf, size_t & size_after_pop);
+
+        int top(int & i);
+        int top(std::string & buf);
+
+        int push(int i);
+        int push(const std::string & buf);
+
+    protected:
+        static const size_t NO_SIZE = std::numeric_limits<size_t>::max();
+};
+
+#endif
@@ -0,0 +1,223 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <algorithm>
+#include "thread_pool.h"
+#include "../system/numa.h"
+
+using std::mutex;
+using std::unique_lock;
+using std::lock_guard;
+
+namespace Util { namespace Parallel {
+
+struct ThreadPool::Job {
+
+	struct Range {
+		mutex mtx;
+		size_t begin, end;
+	};
+
+	Job(size_t thread_count, size_t partition_count, const Task &f) :
+		f(f),
+		thread_count(thread_count),
+		partition_count(partition_count),
+		ranges(new Range[thread_count]),
+		next_slot(1),
+		active(1),
+		failed(false)
+	{
+		for (size_t i = 0; i < thread_count; ++i) {
+			ranges[i].begin = partition_count * i / thread_count;
+			ranges[i].end = partition_count * (i + 1) / thread_count;
+		}
+	}
+
+	bool pop(size_t slot, size_t &p)
+	{
+		Range &r = ranges[slot];
+		lock_guard<mutex> lock(r.mtx);
+		if (r.begin >= r.end)
+			return false;
+		p = r.begin++;
+		return true;
+	}
+
+	// With NUMA binding, ranges of slots on the same node are preferred.
+	bool steal(size_t slot)
+	{
+		return (Numa::active() && steal(slot, true)) || steal(slot, false);
+	}
+
+	bool steal(size_t slot, bool same_node)
+	{
+		const size_t node = same_node ? Numa::slot_node(slot, thread_count, partition_count) : 0;
+		size_t victim = thread_count, size = 0;
+		for (size_t i = 0; i < thread_count; ++i) {
+			if (i == slot || (same_node && Numa::slot_node(i, thread_count, partition_count) != node))
+				continue;
+			size_t n;
+			{
+				lock_guard<mutex> lock(ranges[i].mtx);
+				n = ranges[i].end - ranges[i].begin;
+			}
+			if (n > size) {
+				victim = i;
+				size = n;
+			}
+		}
+		if (victim == thread_count)
+			return false;
+		size_t begin, end;
+		{
+			Range &r = ranges[victim];
+			lock_guard<mutex> lock(r.mtx);
+			if (r.begin >= r.end)
+				return true;
+			end = r.end;
+			begin = end - (r.end - r.begin + 1) / 2;
+			r.end = begin;
+		}
+		Range &r = ranges[slot];
+		lock_guard<mutex> lock(r.mtx);
+		r.begin = begin;
+		r.end = end;
+		return true;
+	}
+
+	void participate(size_t slot)
+	{
+		if (Numa::active()) {
+			const int prev = Numa::bind_thread((int)Numa::slot_node(slot, thread_count, partition_count));
+			work(slot);
+			Numa::bind_thread(prev);
+		}
+		else
+			work(slot);
+	}
+
+	void work(size_t slot)
+	{
+		size_t p;
+		for (;;) {
+			if (!pop(slot, p)) {
+				if (steal(slot))
+					continue;
+				return;
+			}
+			if (failed)
+				continue;
+			try {
+				f(p, slot);
+			}
+			catch (...) {
+				if (!failed.exchange(true))
+					error = std::current_exception();
+			}
+		}
+	}
+
+	const Task &f;
+	const size_t thread_count, partition_count;
+	std::unique_ptr<Range[]> ranges;
+	size_t next_slot, active;
+	std::atomic<bool> failed;
+	std::exception_ptr error;
+	std::condition_variable done;
+
+};
+
+ThreadPool::ThreadPool() :
+	stop_(false)
+{}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(mtx_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+	for (std::thread &t : workers_)
+		t.join();
+}
+
+ThreadPool& ThreadPool::get()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::worker()
+{
+	unique_lock<mutex> lock(mtx_);
+	for (;;) {
+		Job *job = nullptr;
+		cv_.wait(lock, [this, &job]() {
+			for (Job *j : jobs_)
+				if (j->next_slot < j->thread_count) {
+					job = j;
+					return true;
+				}
+			return stop_;
+		});
+		if (job == nullptr)
+			return;
+		const size_t slot = job->next_slot++;
+		++job->active;
+		lock.unlock();
+		job->participate(slot);
+		lock.lock();
+		if (--job->active == 0)
+			job->done.notify_all();
+	}
+}
+
+void ThreadPool::run(size_t thread_count, size_t partition_count, const Task &f)
+{
+	thread_count = std::min(thread_count, partition_count);
+	if (thread_count <= 1) {
+		for (size_t i = 0; i < partition_count; ++i)
+			f(i, 0);
+		return;
+	}
+
+	Job job(thread_count, partition_count, f);
+	{
+		lock_guard<mutex> lock(mtx_);
+		while (workers_.size() < thread_count - 1)
+			workers_.emplace_back(&ThreadPool::worker, this);
+		jobs_.push_back(&job);
+	}
+	cv_.notify_all();
+
+	job.participate(0);
+
+	{
+		unique_lock<mutex> lock(mtx_);
+		jobs_.remove(&job);
+		--job.active;
+		job.done.wait(lock, [&job]() { return job.active == 0; });
+	}
+	if (job.error)
+		std::rethrow_exception(job.error);
+}
+
+}}
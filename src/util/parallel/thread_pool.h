@@ -4,32 +4,55 @@
 #include <thread>
 #include <atomic>
 #include <vector>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
 
 namespace Util { namespace Parallel {
 
-template<typename _f, typename... _args>
-void pool_worker(std::atomic<size_t> *partition, size_t thread_id, size_t partition_count, _f f, _args... args) {
-	size_t p;
-	while ((p = (*partition)++) < partition_count) {
-		f(p, thread_id, args...);
-	}
-}
+// Process-wide set of worker threads that is reused by all parallel phases.
+// A job of n partitions is split into one contiguous range per participating
+// thread. Participants process their own range from the front and, once it is
+// exhausted, steal the upper half of the largest remaining range. The calling
+// thread always takes part in its own job, so jobs may be nested or submitted
+// from several threads at once.
+struct ThreadPool {
 
-template<typename _f, typename... _args>
-void scheduled_thread_pool(size_t thread_count, _f f, _args... args) {
-	std::atomic<size_t> partition(0);
-	std::vector<std::thread> threads;
-	for (size_t i = 0; i < thread_count; ++i)
-		threads.emplace_back(f, &partition, i, args...);
-	for (std::thread &t : threads)
-		t.join();
-}
+	typedef std::function<void(size_t, size_t)> Task;
+
+	static ThreadPool& get();
+
+	// Calls f(partition, thread_id) for every partition in [0, partition_count),
+	// using at most thread_count threads. thread_id is unique among the threads
+	// working on the job and less than thread_count. The first exception thrown
+	// by a task is rethrown to the caller.
+	void run(size_t thread_count, size_t partition_count, const Task &f);
+
+	~ThreadPool();
+
+private:
+
+	struct Job;
+
+	ThreadPool();
+	void worker();
+
+	std::mutex mtx_;
+	std::condition_variable cv_;
+	std::vector<std::thread> workers_;
+	std::list<Job*> jobs_;
+	bool stop_;
+
+};
 
 template<typename _f, typename... _args>
 void scheduled_thread_pool_auto(size_t thread_count, size_t partition_count, _f f, _args... args) {
-	scheduled_thread_pool(thread_count, pool_worker<_f, _args...>, partition_count, f, args...);
+	ThreadPool::get().run(thread_count, partition_count, [&](size_t p, size_t thread_id) { f(p, thread_id, args...); });
 }
 
 }}
 
-#endif
\ No newline at end of file
+#endif
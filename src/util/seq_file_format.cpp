@@ -47,7 +47,8 @@ void copy_line(const string & s, vector<_t>& v, size_t d, const Value_traits& va
 		v.push_back(convert_char<_what>(*i, value_traits));
 }
 
-bool FASTA_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+template<typename _t, typename _what>
+static bool get_fasta_seq(string& id, vector<_t>& seq, TextInputFile & s, const Value_traits& value_traits, _what)
 {
 	// !!!
 	while (s.getline(), s.line.empty() && !s.eof());
@@ -70,7 +71,7 @@ bool FASTA_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, c
 			break;
 		}
 		try {
-			copy_line(s.line, seq, 0, value_traits, Sequence_data());
+			copy_line(s.line, seq, 0, value_traits, _what());
 		}
 		catch (invalid_sequence_char_exception &e) {
 			throw StreamReadException(s.line_count, e.what());
@@ -79,7 +80,8 @@ bool FASTA_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, c
 	return true;
 }
 
-bool FASTQ_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+template<typename _t, typename _what>
+static bool get_fastq_seq(string& id, vector<_t>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual, _what)
 {
 	while (s.getline(), s.line.empty() && !s.eof());
 	if (s.line.empty() && s.eof())
@@ -90,7 +92,7 @@ bool FASTQ_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, c
 	id = s.line.substr(1);
 	s.getline();
 	try {
-		copy_line(s.line, seq, 0, value_traits, Sequence_data());
+		copy_line(s.line, seq, 0, value_traits, _what());
 	}
 	catch (invalid_sequence_char_exception &e) {
 		throw StreamReadException(s.line_count, e.what());
@@ -106,6 +108,26 @@ bool FASTQ_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, c
 	return true;
 }
 
+bool FASTA_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+{
+	return get_fasta_seq(id, seq, s, value_traits, Sequence_data());
+}
+
+bool FASTA_format::get_raw_seq(string& id, vector<char>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+{
+	return get_fasta_seq(id, seq, s, value_traits, Raw_text());
+}
+
+bool FASTQ_format::get_seq(string& id, vector<Letter>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+{
+	return get_fastq_seq(id, seq, s, value_traits, qual, Sequence_data());
+}
+
+bool FASTQ_format::get_raw_seq(string& id, vector<char>& seq, TextInputFile & s, const Value_traits& value_traits, vector<char> *qual) const
+{
+	return get_fastq_seq(id, seq, s, value_traits, qual, Raw_text());
+}
+
 const Sequence_file_format * guess_format(TextInputFile &file)
 {
 	static const FASTA_format fasta;
@@ -38,6 +38,8 @@ struct Sequence_file_format
 {
 
 	virtual bool get_seq(std::string &id, std::vector<Letter> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const = 0;
+	// Reads the next record without converting the sequence letters.
+	virtual bool get_raw_seq(std::string &id, std::vector<char> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const = 0;
 	virtual ~Sequence_file_format()
 	{ }
 	
@@ -50,6 +52,7 @@ struct FASTA_format : public Sequence_file_format
 	{ }
 
 	virtual bool get_seq(std::string &id, std::vector<Letter> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const override;
+	virtual bool get_raw_seq(std::string &id, std::vector<char> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const override;
 
 	virtual ~FASTA_format()
 	{ }
@@ -63,6 +66,7 @@ struct FASTQ_format : public Sequence_file_format
 	{ }
 
 	virtual bool get_seq(std::string &id, std::vector<Letter> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const override;
+	virtual bool get_raw_seq(std::string &id, std::vector<char> &seq, TextInputFile &s, const Value_traits& value_traits, std::vector<char> *qual = nullptr) const override;
 
 	virtual ~FASTQ_format()
 	{ }
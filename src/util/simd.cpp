@@ -37,6 +37,18 @@ inline void cpuid(int CPUInfo[4], int InfoType) {
 #endif
 #endif
 
+#ifdef __SSE2__
+static inline uint64_t xgetbv() {
+#ifdef _WIN32
+	return _xgetbv(0);
+#else
+	uint32_t eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return (uint64_t)edx << 32 | eax;
+#endif
+}
+#endif
+
 namespace SIMD {
 
 int flags = 0;
@@ -58,10 +70,15 @@ Arch init_arch() {
 		flags |= POPCNT;
 	if ((info[2] & (1 << 19)) != 0)
 		flags |= SSE4_1;
+	// the OS has to save the opmask and zmm registers on context switches
+	const bool os_avx512 = (info[2] & (1 << 27)) != 0 && (xgetbv() & 0xe6) == 0xe6;
 	if (nids >= 7) {
 		cpuid(info, 7);
 		if ((info[1] & (1 << 5)) != 0)
 			flags |= AVX2;
+		// AVX512F, AVX512BW, AVX512VL
+		if (os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && (info[1] & (1u << 31)) != 0)
+			flags |= AVX512;
 	}
 #endif
 
@@ -81,7 +98,13 @@ Arch init_arch() {
 	if ((flags & AVX2) == 0)
 		throw std::runtime_error("CPU does not support AVX2. Please compile the software from source.");
 #endif
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+	if ((flags & AVX512) == 0)
+		throw std::runtime_error("CPU does not support AVX-512. Please compile the software from source.");
+#endif
 
+	if ((flags & SSSE3) && (flags & POPCNT) && (flags & SSE4_1) && (flags & AVX2) && (flags & AVX512))
+		return Arch::AVX512;
 	if ((flags & SSSE3) && (flags & POPCNT) && (flags & SSE4_1) && (flags & AVX2))
 		return Arch::AVX2;
 	if ((flags & SSSE3) && (flags & POPCNT) && (flags & SSE4_1))
@@ -105,6 +128,8 @@ std::string features() {
 		r.push_back("sse4.1");
 	if (flags & AVX2)
 		r.push_back("avx2");
+	if (flags & AVX512)
+		r.push_back("avx512");
 	return r.empty() ? "None" : join(" ", r);
 }
 
@@ -0,0 +1,44 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#pragma once
+#include <algorithm>
+#include "../simd.h"
+#include "transpose32x32.h"
+
+// Transposes a 64x64 byte matrix as four 32x32 blocks. As for the smaller
+// transposes, n < 64 input rows are placed into the last n output columns.
+static inline void transpose(const signed char** data, size_t n, signed char* out, const __m512i&) {
+	alignas(32) signed char t[32 * 32];
+	const signed char* ptr[32];
+	const size_t n_hi = std::min(n, (size_t)32), n_lo = n - n_hi;
+	for (size_t row = 0; row < 64; row += 32) {
+		for (size_t i = 0; i < n_lo; ++i)
+			ptr[i] = data[i] + row;
+		transpose(ptr, n_lo, t, __m256i());
+		for (size_t i = 0; i < 32; ++i)
+			_mm256_store_si256((__m256i*)(out + (row + i) * 64), _mm256_load_si256((const __m256i*)(t + i * 32)));
+		for (size_t i = 0; i < n_hi; ++i)
+			ptr[i] = data[n_lo + i] + row;
+		transpose(ptr, n_hi, t, __m256i());
+		for (size_t i = 0; i < 32; ++i)
+			_mm256_store_si256((__m256i*)(out + (row + i) * 64 + 32), _mm256_load_si256((const __m256i*)(t + i * 32)));
+	}
+}
@@ -0,0 +1,157 @@
+/****
+DIAMOND protein aligner
+Copyright (C) 2020 Max Planck Society for the Advancement of Science e.V.
+
+Code developed by Benjamin Buchfink <benjamin.buchfink@tue.mpg.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****/
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdlib.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "numa.h"
+#include "../parallel/thread_pool.h"
+#include "../log_stream.h"
+
+using std::string;
+using std::vector;
+using std::endl;
+
+namespace Numa {
+
+#ifdef __linux__
+
+static vector<cpu_set_t> node_cpus;
+static cpu_set_t process_cpus;
+static thread_local int bound_node = -1;
+
+// Parses a list such as "0-3,8,10-11".
+static vector<int> parse_list(const string &file_name)
+{
+	vector<int> v;
+	std::ifstream in(file_name);
+	string s;
+	if (!std::getline(in, s))
+		return v;
+	const char *p = s.c_str();
+	while (*p) {
+		char *end;
+		const long begin = strtol(p, &end, 10);
+		if (end == p)
+			break;
+		long last = begin;
+		p = end;
+		if (*p == '-') {
+			last = strtol(p + 1, &end, 10);
+			p = end;
+		}
+		for (long i = begin; i <= last; ++i)
+			v.push_back((int)i);
+		if (*p == ',')
+			++p;
+	}
+	return v;
+}
+
+void init()
+{
+	if (sched_getaffinity(0, sizeof(process_cpus), &process_cpus) != 0)
+		return;
+	node_cpus.clear();
+	for (int node : parse_list("/sys/devices/system/node/online")) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int cpu : parse_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+			if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &process_cpus))
+				CPU_SET(cpu, &set);
+		if (CPU_COUNT(&set) > 0)
+			node_cpus.push_back(set);
+	}
+	verbose_stream << "NUMA nodes: " << node_cpus.size() << endl;
+	if (node_cpus.size() < 2)
+		node_cpus.clear();
+}
+
+bool active()
+{
+	return !node_cpus.empty();
+}
+
+size_t nodes()
+{
+	return std::max(node_cpus.size(), (size_t)1);
+}
+
+int bind_thread(int node)
+{
+	const int prev = bound_node;
+	if (!active() || node == bound_node)
+		return prev;
+	const cpu_set_t &set = node < 0 ? process_cpus : node_cpus[node];
+	if (sched_setaffinity(0, sizeof(set), &set) == 0)
+		bound_node = node;
+	return prev;
+}
+
+#else
+
+void init()
+{}
+
+bool active()
+{
+	return false;
+}
+
+size_t nodes()
+{
+	return 1;
+}
+
+int bind_thread(int node)
+{
+	return -1;
+}
+
+#endif
+
+size_t slot_node(size_t slot, size_t thread_count, size_t partition_count)
+{
+	const size_t t = std::max(std::min(thread_count, partition_count), (size_t)1);
+	return slot * nodes() / t;
+}
+
+size_t partition_node(size_t p, size_t thread_count, size_t partition_count)
+{
+	const size_t t = std::max(std::min(thread_count, partition_count), (size_t)1);
+	return slot_node(((p + 1) * t - 1) / partition_count, thread_count, partition_count);
+}
+
+void first_touch(char *ptr, const std::vector<size_t> &offsets, size_t thread_count)
+{
+	if (!active() || offsets.size() < 2)
+		return;
+	Util::Parallel::ThreadPool::get().run(thread_count, offsets.size() - 1, [ptr, &offsets](size_t p, size_t) {
+		memset(ptr + offsets[p], 0, offsets[p + 1] - offsets[p]);
+	});
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+// NUMA aware execution of thread pool jobs (option --numa). The slots of a
+// job are split into one contiguous group per node, and each participating
+// thread is bound to the CPUs of its slot's node while it works on the job.
+// Since the thread pool hands out partitions to slots in contiguous ranges,
+// this assigns the seed partitions of a search to nodes in the same way in
+// every phase, and memory that is first written by the thread working on a
+// partition stays local to that partition's node.
+namespace Numa {
+
+// Detects the NUMA nodes of the system and enables thread binding if there is
+// more than one.
+void init();
+bool active();
+size_t nodes();
+
+// Node of a thread pool slot and home node of a partition, for a job of
+// partition_count partitions run with at most thread_count threads.
+size_t slot_node(size_t slot, size_t thread_count, size_t partition_count);
+size_t partition_node(size_t p, size_t thread_count, size_t partition_count);
+
+// Binds the calling thread to the CPUs of a node (or all nodes for -1) and
+// returns the previous binding.
+int bind_thread(int node);
+
+// Writes zeros to the buffer with one task per partition, so that the pages
+// of each partition are placed on its home node. Partition i occupies the
+// bytes [offsets[i], offsets[i + 1]).
+void first_touch(char *ptr, const std::vector<size_t> &offsets, size_t thread_count);
+
+}
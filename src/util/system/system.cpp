@@ -160,7 +160,7 @@ double total_ram() {
 #define handle_error(msg) \
            do { perror(msg); exit(EXIT_FAILURE); } while (0)
 
-std::tuple<char*, size_t, int> mmap_file(const char* filename) {
+std::tuple<char*, size_t, int> mmap_file(const char* filename, bool copy_on_write) {
 #ifdef WIN32
 	return { nullptr, 0, -1 };
 #else
@@ -178,8 +178,8 @@ std::tuple<char*, size_t, int> mmap_file(const char* filename) {
 
 	length = sb.st_size;
 
-	addr = mmap(NULL, length, PROT_READ,
-		MAP_SHARED, fd, 0);
+	addr = copy_on_write ? mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+		: mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
 	if (addr == MAP_FAILED)
 		handle_error("mmap");
 	return { (char*)addr, length, fd };
@@ -192,4 +192,12 @@ void unmap_file(char* ptr, size_t size, int fd) {
 	munmap((void*)ptr, size);
 	close(fd);
 #endif
-}
\ No newline at end of file
+}
+void discard_mapped_pages(char* ptr, size_t size) {
+#ifdef WIN32
+#else
+	const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	char* begin = (char*)((size_t)ptr / page_size * page_size);
+	madvise((void*)begin, ptr + size - begin, MADV_DONTNEED);
+#endif
+}
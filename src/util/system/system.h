@@ -16,8 +16,9 @@ size_t getPeakRSS();
 void log_rss();
 size_t file_size(const char* name);
 double total_ram();
-std::tuple<char*, size_t, int> mmap_file(const char* filename);
+std::tuple<char*, size_t, int> mmap_file(const char* filename, bool copy_on_write = false);
 void unmap_file(char* ptr, size_t size, int fd);
+void discard_mapped_pages(char* ptr, size_t size);
 
 #ifdef _MSC_VER
 #define POPEN _popen